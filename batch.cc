@@ -0,0 +1,146 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "batch.h"
+#include <utility>
+#include <algorithm>
+
+namespace {
+    // Batch whose 'pump' submits a request on this thread (if any).
+    thread_local Batch const* pumping{};
+}
+
+Batch::Batch(std::span<Request const> const requests, Method const method, BatchLimits const limits, Callback callback, Submit submit)
+        : requests_{requests}, method_{method}, limits_{limits}, callback_{std::move(callback)}, submit_{std::move(submit)}
+{
+    limits_.total = std::max<size_t>(limits_.total, 1);
+    limits_.per_host = std::max<size_t>(limits_.per_host, 1);
+    for (size_t i = 0; i < requests_.size(); ++i) {
+        auto [it, added] = hosts_.try_emplace(requests_[i].host());
+        if (added)
+            order_.push_back(&it->second);
+        it->second.waiting.push_back(i);
+    }
+}
+
+//-------------------------------------------------------------------
+/// Submit the first requests and wait until all of them complete.
+//-------------------------------------------------------------------
+void Batch::run() {
+    std::unique_lock lock(mutex_);
+    pump(lock);
+    // Another thread may be still in 'pump' after the last completion.
+    finished_.wait(lock, [this] { return done(); });
+}
+
+//-------------------------------------------------------------------
+/// Submit the first requests without waiting for them.
+/// \param finished - called when all requests are completed.
+//-------------------------------------------------------------------
+void Batch::start(std::function<void()> finished) {
+    std::unique_lock lock(mutex_);
+    on_finished_ = std::move(finished);
+    if (requests_.empty())
+        return finish(lock);
+    pump(lock);
+}
+
+/********************************************************************
+*                                                                   *
+*                         P R I V A T E                             *
+*                                                                   *
+********************************************************************/
+
+/// Submit waiting requests while the limits allow it. Hosts are
+/// visited round-robin, so one busy host doesn't starve the others.
+/// Requests completed during their submit (e.g. the engine stopped)
+/// are followed by this loop, not by a nested 'pump'.
+void Batch::pump(std::unique_lock<std::mutex>& lock) {
+    while (running_ < limits_.total) {
+        Host* host{};
+        for (size_t n = 0; n < order_.size() && !host; ++n) {
+            auto const candidate = order_[cursor_];
+            cursor_ = (cursor_ + 1) % order_.size();
+            if (!candidate->waiting.empty() && candidate->running < limits_.per_host)
+                host = candidate;
+        }
+        if (!host)
+            return;
+
+        auto const index = host->waiting.front();
+        host->waiting.pop_front();
+        ++host->running;
+        ++running_;
+        ++submitting_;
+        // The completion may come at once (on failure), so submit without the lock.
+        lock.unlock();
+        auto const outer = std::exchange(pumping, this);
+        submit_(method_, requests_[index], [this, index, host](Result<Response> result) {
+            complete(index, *host, std::move(result));
+        });
+        pumping = outer;
+        lock.lock();
+        if (--submitting_ == 0 && done())
+            return finish(lock);
+    }
+}
+
+/// Deliver the result and submit the next requests.
+void Batch::complete(size_t const index, Host& host, Result<Response> result) {
+    callback_(index, std::move(result));
+
+    std::unique_lock lock(mutex_);
+    --host.running;
+    --running_;
+    ++completed_;
+    if (done())
+        return finish(lock);
+    // Completed inside our submit, the 'pump' below on the stack goes on.
+    if (pumping != this)
+        pump(lock);
+}
+
+/// Signal the end of the batch (call with the lock). The batch may die
+/// right after, so the callers return without touching it.
+void Batch::finish(std::unique_lock<std::mutex>& lock) {
+    if (!on_finished_) {
+        // Notify under the lock, 'run()' returns (and the batch dies) right after.
+        finished_.notify_all();
+        return;
+    }
+    auto const finished = std::move(on_finished_);
+    lock.unlock();
+    finished();
+}
+
+/// All requests are completed and no thread is submitting (call with the lock).
+bool Batch::done() const noexcept {
+    return completed_ == requests_.size() && submitting_ == 0;
+}
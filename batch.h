@@ -0,0 +1,96 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <span>
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <string>
+#include <functional>
+#include <string_view>
+#include <unordered_map>
+#include <condition_variable>
+#include "method.h"
+#include "request.h"
+#include "response.h"
+
+/// Max number of requests of a batch running at once.
+struct BatchLimits {
+    size_t total{64};
+    size_t per_host{8};
+};
+
+/// Scheduler of a batch of requests: keeps the number of running requests
+/// within the limits, submits the next ones as the running ones complete.
+/// Only indices wait in the queues, requests are copied when submitted.
+/// Completions may come on many threads at once (engines of a reactor).
+class Batch {
+public:
+    // Called with the index of the request and its result, as requests complete.
+    using Callback = std::function<void(size_t, Result<Response>)>;
+    using Submit = std::function<void(Method, Request, std::function<void(Result<Response>)>)>;
+private:
+    struct Host {
+        std::deque<size_t> waiting{};
+        size_t running{};
+    };
+    std::span<Request const> requests_;
+    Method method_;
+    BatchLimits limits_;
+    Callback callback_;
+    Submit submit_;
+    std::mutex mutex_{};
+    std::condition_variable finished_{};
+    std::function<void()> on_finished_{};   // set by 'start', 'run' waits for 'finished_'
+    std::unordered_map<std::string_view, Host> hosts_{};
+    std::vector<Host*> order_{};    // hosts in order of their first request
+    size_t cursor_{};               // round-robin position in 'order_'
+    size_t running_{};
+    size_t completed_{};
+    size_t submitting_{};           // threads in 'pump' calling 'submit_' (without the lock)
+public:
+    Batch(std::span<Request const> requests, Method method, BatchLimits limits, Callback callback, Submit submit);
+    Batch(Batch const&) = delete;
+    Batch& operator=(Batch const&) = delete;
+
+    /// Run all requests, returns when all of them are completed.
+    void run();
+    /// Submit the first requests and return, 'finished' is called when all of them
+    /// are completed (on the thread of the last completion, possibly inside this call).
+    /// The batch may be destroyed in 'finished', it isn't touched afterwards.
+    void start(std::function<void()> finished);
+
+private:
+    void pump(std::unique_lock<std::mutex>& lock);
+    void finish(std::unique_lock<std::mutex>& lock);
+    void complete(size_t index, Host& host, Result<Response> result);
+    [[nodiscard]] bool done() const noexcept;
+};
@@ -0,0 +1,60 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <array>
+#include "curlex.h"
+#include "bench.h"
+#include "server.h"
+
+/// A batch of 10k requests to four loopback servers, with limits per host
+/// and without them (each response takes 1 ms on the server).
+int main() {
+    std::array<TestServer, 4> servers;
+    std::vector<Request> requests;
+    size_t const n = 10'000;
+    for (size_t i = 0; i < n; ++i)
+        requests.push_back(Request().scheme("http").host(servers[i % servers.size()].host())
+                                   .endpoint("sleep").add_param("ms", 1).build());
+
+    for (auto const limits : {BatchLimits{.total = 64, .per_host = 4}, BatchLimits{.total = 64, .per_host = 16},
+                              BatchLimits{.total = n, .per_host = n}}) {
+        Curlex cx;
+        size_t ok{};
+        auto const elapsed = bench::seconds([&] {
+            cx.execute_batch(requests, [&ok](size_t, Result<Response> result) {
+                ok += result.has_value();
+            }, limits);
+        });
+        auto const name = limits.per_host == n ? std::string("unlimited")
+                                              : fmt::format("{} per host, {} in total", limits.per_host, limits.total);
+        bench::row(fmt::format("{}: requests ok", name), static_cast<double>(ok), "");
+        bench::row(fmt::format("{}: throughput", name), static_cast<double>(n) / elapsed, "req/s");
+    }
+}
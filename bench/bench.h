@@ -0,0 +1,68 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <chrono>
+#include <string_view>
+#include <fmt/core.h>
+
+// Helpers of the benchmarks: timing and reporting.
+namespace bench {
+    using Clock = std::chrono::steady_clock;
+
+    /// Keep the value, so the compiler doesn't drop its computation.
+    template<typename T>
+    inline void keep(T const& value) noexcept {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+
+    /// Seconds taken by the function.
+    template<typename F>
+    inline double seconds(F&& fn) {
+        auto const start = Clock::now();
+        fn();
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    /// Nanoseconds per call of the function (called 'n' times after a warm-up).
+    template<typename F>
+    inline double ns_per_op(size_t const n, F&& fn) {
+        for (size_t i = 0; i < n / 10 + 1; ++i)
+            fn();
+        return seconds([&] {
+            for (size_t i = 0; i < n; ++i)
+                fn();
+        }) * 1e9 / static_cast<double>(n);
+    }
+
+    inline void row(std::string_view const name, double const value, std::string_view const unit) {
+        fmt::print("{:<48} {:>12.1f} {}\n", name, value, unit);
+    }
+}
@@ -0,0 +1,66 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <atomic>
+#include <thread>
+#include "curlex.h"
+#include "bench.h"
+#include "server.h"
+
+/// Cost of constructing a client (the libcurl runtime is initialized once per
+/// process), and 64 threads starting at once, each with its own client.
+int main() {
+    TestServer server;
+    bench::row("first Curlex (initializes libcurl)", bench::seconds([] { Curlex cx; }) * 1e6, "us");
+    bench::row("Curlex construction + destruction", bench::ns_per_op(100'000, [] {
+        Curlex cx;
+        bench::keep(cx);
+    }) / 1000, "us");
+
+    auto const req = Request().scheme("http").host(server.host()).endpoint("size").add_param("n", 10).build();
+    std::atomic<size_t> ok{};
+    std::atomic<bool> go{};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 64; ++i)
+        threads.emplace_back([&] {
+            while (!go)
+                std::this_thread::yield();
+            Curlex cx;
+            if (auto const response = cx.GET(req); response && response->code() == 200)
+                ok.fetch_add(1);
+        });
+    auto const elapsed = bench::seconds([&] {
+        go = true;
+        for (auto& thread : threads)
+            thread.join();
+    });
+    bench::row("64 threads: construct + GET, requests ok", static_cast<double>(ok), "");
+    bench::row("64 threads: construct + GET, all done in", elapsed * 1000, "ms");
+}
@@ -0,0 +1,58 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <atomic>
+#include "curlex.h"
+#include "bench.h"
+#include "server.h"
+
+/// Requests per second on the loopback: sequential GETs on one handle
+/// and the same requests in flight at once on the engine.
+int main() {
+    TestServer server;
+    size_t const n = 5000;
+    auto const req = Request().scheme("http").host(server.host()).endpoint("size").add_param("n", 100).build();
+    Curlex cx;
+    cx.persistent();
+
+    auto const sequential = bench::seconds([&] {
+        for (size_t i = 0; i < n; ++i)
+            bench::keep(cx.GET(req));
+    });
+    bench::row("sequential GET", static_cast<double>(n) / sequential, "req/s");
+
+    for (size_t const in_flight : {8, 32, 128}) {
+        auto const concurrent = bench::seconds([&] {
+            cx.execute_batch(std::vector<Request>(n, req), [](size_t, Result<Response>) {},
+                             BatchLimits{.total = in_flight, .per_host = in_flight});
+        });
+        bench::row(fmt::format("async GET, {} in flight", in_flight), static_cast<double>(n) / concurrent, "req/s");
+    }
+}
@@ -0,0 +1,71 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <cstdlib>
+#include "curlex.h"
+#include "bench.h"
+
+/// Connections and latency of concurrent requests to an h2c server, over
+/// HTTP/1.1 and over HTTP/2 (prior knowledge, streams multiplexed). The server
+/// isn't part of the benchmark and must speak both on a plain port (e.g. h2o):
+///     bench_http2 127.0.0.1:8080 /file
+int main(int const argc, char const* const argv[]) {
+    if (argc < 3) {
+        fmt::print("usage: {} host:port /path\n", argv[0]);
+        return 0;
+    }
+    size_t const n = 2000;
+    auto const req = Request().scheme("http").host(argv[1]).endpoint(std::string(argv[2]).substr(1)).build();
+    std::vector<Request> requests(n, req);
+
+    for (auto const version : {HttpVersion::Http1_1, HttpVersion::Http2PriorKnowledge}) {
+        auto const metrics = std::make_shared<Metrics>();
+        Curlex cx;
+        cx.metrics(metrics).http_version(version);
+        size_t ok{};
+        std::string failure{};
+        auto const elapsed = bench::seconds([&] {
+            for (auto const& result : cx.execute_batch(requests, BatchLimits{.total = 100, .per_host = 100}))
+                if (result && result->code() == 200)
+                    ++ok;
+                else if (failure.empty())
+                    failure = result ? fmt::format("status {}", result->code()) : result.error().message();
+        });
+        auto const snapshot = metrics->snapshot();
+        auto const name = version == HttpVersion::Http1_1 ? "HTTP/1.1" : "HTTP/2 (h2c)";
+        bench::row(fmt::format("{}: requests ok of {}", name, n), static_cast<double>(ok), "");
+        if (!failure.empty())
+            fmt::print("{}: first failure: {}\n", name, failure);
+        bench::row(fmt::format("{}: new connections", name), static_cast<double>(snapshot.connections_new), "");
+        bench::row(fmt::format("{}: p50 latency", name), static_cast<double>(metrics->percentile(req.host(), 0.5, 1).value_or(0)), "us");
+        bench::row(fmt::format("{}: p99 latency", name), static_cast<double>(metrics->percentile(req.host(), 0.99, 1).value_or(0)), "us");
+        bench::row(fmt::format("{}: throughput", name), static_cast<double>(n) / elapsed, "req/s");
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "request.h"
+#include "response.h"
+#include "bench.h"
+
+struct Item {
+    int64_t id{};
+    std::string name{};
+    double price{};
+    std::vector<std::string> tags{};
+};
+
+struct Order {
+    std::string customer{};
+    std::vector<Item> items{};
+};
+
+/// JSON: serialize into the request's body and parse from the receive buffer,
+/// compared with serializing to a string and copying it (and the reverse).
+int main() {
+    Order order{"customer-0001", {}};
+    for (int64_t i = 0; i < 100; ++i)
+        order.items.push_back({i, fmt::format("item {}", i), 9.99 * static_cast<double>(i), {"a", "b", "c"}});
+    size_t const n = 20'000;
+
+    Request req;
+    bench::row("request, write_json to a string + copy", bench::ns_per_op(n, [&] {
+        std::string text;
+        (void)glz::write_json(order, text);
+        req.body(text);
+        bench::keep(req.body());
+    }), "ns");
+    bench::row("request, Request::json", bench::ns_per_op(n, [&] {
+        req.json(order);
+        bench::keep(req.body());
+    }), "ns");
+
+    Response response(200);
+    response.body(std::string(req.body()));
+    bench::row("response, copy of the body + read_json", bench::ns_per_op(n, [&] {
+        std::string const text = response.body();
+        Order value{};
+        (void)glz::read_json(value, text);
+        bench::keep(value);
+    }), "ns");
+    bench::row("response, Response::json", bench::ns_per_op(n, [&] {
+        bench::keep(response.json<Order>());
+    }), "ns");
+}
@@ -0,0 +1,51 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "curlex.h"
+#include "bench.h"
+#include "server.h"
+
+/// Per-request overhead of applying options: every option set again after
+/// curl_easy_reset, or only those which differ (persistent configuration).
+int main() {
+    TestServer server;
+    size_t const n = 5000;
+    auto const req = Request().scheme("http").host(server.host()).endpoint("size").add_param("n", 10).build()
+            .add_header("Accept", "text/plain").add_header("X-Trace", 12345);
+
+    Curlex reset;
+    Curlex persistent;
+    persistent.persistent();
+    auto const before = bench::ns_per_op(n, [&] { bench::keep(reset.GET(req)); });
+    auto const after = bench::ns_per_op(n, [&] { bench::keep(persistent.GET(req)); });
+    bench::row("GET, handle reset after every request", before / 1000, "us");
+    bench::row("GET, persistent configuration", after / 1000, "us");
+    bench::row("difference per request", (before - after) / 1000, "us");
+}
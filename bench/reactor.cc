@@ -0,0 +1,59 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <array>
+#include <thread>
+#include "curlex.h"
+#include "bench.h"
+#include "server.h"
+
+/// Throughput of asynchronous requests on 1/2/4/8 engine threads.
+/// The servers run in this process too, so give it enough cores.
+int main() {
+    fmt::print("hardware threads: {}\n", std::thread::hardware_concurrency());
+    std::array<TestServer, 8> servers;
+    std::vector<Request> requests;
+    size_t const n = 20'000;
+    for (size_t i = 0; i < n; ++i)
+        requests.push_back(Request().scheme("http").host(servers[i % servers.size()].host())
+                                   .endpoint("size").add_param("n", 100).build());
+
+    for (size_t const threads : {1, 2, 4, 8}) {
+        Curlex cx;
+        cx.threads(threads);
+        // Warm up: connections and engines.
+        cx.execute_batch(std::span(requests).first(1000), [](size_t, Result<Response>) {},
+                         BatchLimits{.total = 256, .per_host = 32});
+        auto const elapsed = bench::seconds([&] {
+            cx.execute_batch(requests, [](size_t, Result<Response>) {}, BatchLimits{.total = 256, .per_host = 32});
+        });
+        bench::row(fmt::format("{} engine thread(s)", threads), static_cast<double>(n) / elapsed, "req/s");
+    }
+}
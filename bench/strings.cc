@@ -0,0 +1,125 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <numeric>
+#include <sstream>
+#include <algorithm>
+#include "shared.h"
+#include "response.h"
+#include "bench.h"
+
+// The previous implementation (istringstream, fmt::format per element), for comparison.
+namespace before {
+    std::string trim(std::string s) {
+        auto const not_space = [](unsigned char c) { return !std::isspace(c); };
+        s.erase(std::find_if(s.rbegin(), s.rend(), not_space).base(), s.end());
+        s.erase(s.begin(), std::find_if(s.begin(), s.end(), not_space));
+        return s;
+    }
+    std::vector<std::string> split(std::string const& text, char const delimiter) {
+        std::vector<std::string> tokens;
+        tokens.reserve(std::count(text.begin(), text.end(), delimiter) + 1);
+        std::string token;
+        std::istringstream stream(text);
+        while (std::getline(stream, token, delimiter))
+            if (auto str = trim(token); !str.empty())
+                tokens.push_back(str);
+        return tokens;
+    }
+    std::string join(std::vector<std::string> const& data, char const delimiter) {
+        return std::accumulate(std::next(data.begin()), data.end(), data[0],
+                               [delimiter](std::string a, std::string b) {
+                                   return fmt::format("{}{}{}", std::move(a), delimiter, std::move(b));
+                               });
+    }
+    std::string to_lower(std::string_view const in) {
+        std::string out;
+        out.reserve(in.size());
+        std::transform(in.begin(), in.end(), std::back_inserter(out),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return out;
+    }
+}
+
+/// String utilities over a realistic headers block of a response.
+int main() {
+    std::string const block =
+            "HTTP/1.1 200 OK\r\n"
+            "Date: Sat, 17 Oct 2026 12:00:00 GMT\r\n"
+            "Content-Type: application/json; charset=utf-8\r\n"
+            "Content-Length: 1534\r\n"
+            "Connection: keep-alive\r\n"
+            "Cache-Control: private, max-age=0, must-revalidate\r\n"
+            "ETag: W/\"5fe-1V5Hh0ZQ5Ks1KxkqU9l5nWm0uGQ\"\r\n"
+            "Vary: Accept-Encoding, Accept, Authorization, Origin\r\n"
+            "Strict-Transport-Security: max-age=31536000; includeSubDomains; preload\r\n"
+            "X-Content-Type-Options: nosniff\r\n"
+            "X-Frame-Options: DENY\r\n"
+            "X-Request-Id: 8d2f6c1e-0a7b-4f5e-9c3d-2b1a0e9f8d7c\r\n"
+            "Set-Cookie: session=abcdef0123456789; Path=/; Secure; HttpOnly; SameSite=Lax\r\n"
+            "Server: nginx/1.25.3\r\n"
+            "\r\n";
+    size_t const n = 200'000;
+
+    bench::row("split lines, istringstream (before)", bench::ns_per_op(n, [&] {
+        bench::keep(before::split(block, '\n'));
+    }), "ns");
+    bench::row("split lines, shared::split", bench::ns_per_op(n, [&] {
+        bench::keep(shared::split(block, '\n'));
+    }), "ns");
+    std::vector<std::string_view> views;
+    bench::row("split lines, shared::split_view (reused vector)", bench::ns_per_op(n, [&] {
+        shared::split_view(block, '\n', views);
+        bench::keep(views);
+    }), "ns");
+
+    auto const lines = shared::split(block, '\n');
+    bench::row("join, fmt::format per element (before)", bench::ns_per_op(n, [&] {
+        bench::keep(before::join(lines, '\n'));
+    }), "ns");
+    bench::row("join, shared::join", bench::ns_per_op(n, [&] {
+        bench::keep(shared::join(lines, '\n'));
+    }), "ns");
+
+    bench::row("to_lower of the block (before)", bench::ns_per_op(n, [&] {
+        bench::keep(before::to_lower(block));
+    }), "ns");
+    bench::row("to_lower of the block, shared::to_lower", bench::ns_per_op(n, [&] {
+        bench::keep(shared::to_lower(block));
+    }), "ns");
+
+    bench::row("parse the block, find 3 headers", bench::ns_per_op(n, [&] {
+        Response response(200);
+        response.headers(std::string(block));
+        bench::keep(response.header("content-type"));
+        bench::keep(response.header("etag"));
+        bench::keep(response.header("vary"));
+    }), "ns");
+}
@@ -0,0 +1,66 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <span>
+#include "request.h"
+#include "bench.h"
+
+// The previous builder (a fmt::format per param, no percent-encoding), for comparison.
+std::string build_before(std::string const& host, std::vector<std::pair<std::string, std::string>> const& params) {
+    auto url = fmt::format("{}://{}/{}", "https", host, "lookup");
+    std::span span{params};
+    auto [k, v] = span.front();
+    url += fmt::format("?{}={}", k, v);
+    for (auto const& [key, value] : span.subspan(1))
+        url += fmt::format("&{}={}", key, value);
+    return url;
+}
+
+/// Building URLs with many params.
+int main() {
+    for (size_t const count : {10, 50, 200}) {
+        Request req;
+        req.scheme("https").host("api.example.com").endpoint("lookup");
+        std::vector<std::pair<std::string, std::string>> params;
+        for (size_t i = 0; i < count; ++i) {
+            auto key = fmt::format("id[{}]", i);
+            auto value = fmt::format("user {}/äß&x", i * 7919);
+            req.add_param(key, value);
+            params.emplace_back(std::move(key), std::move(value));
+        }
+        size_t const n = 2'000'000 / count;
+        bench::row(fmt::format("{} params, fmt::format per param (before)", count), bench::ns_per_op(n, [&] {
+            bench::keep(build_before("api.example.com", params));
+        }), "ns");
+        bench::row(fmt::format("{} params, Request::build (encoded)", count), bench::ns_per_op(n, [&] {
+            bench::keep(req.build().url());
+        }), "ns");
+    }
+}
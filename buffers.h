@@ -0,0 +1,124 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <curl/curl.h>
+#include <mutex>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <string_view>
+#include "shared.h"
+
+/// Thread-safe pool of strings reused as body buffers,
+/// so steady traffic doesn't allocate and grow a new buffer for every response.
+class BufferPool {
+    size_t max_count_;
+    size_t max_capacity_;
+    std::mutex mutex_{};
+    std::vector<std::string> buffers_{};
+public:
+    /// \param max_count - max number of kept buffers,
+    /// \param max_capacity - buffers with bigger capacity are released, not kept.
+    explicit BufferPool(size_t const max_count = 64, size_t const max_capacity = 16 * 1024 * 1024) noexcept
+            : max_count_{max_count}, max_capacity_{max_capacity} {}
+
+    /// Take an empty buffer (with capacity left by its previous use).
+    [[nodiscard]] std::string take() noexcept {
+        std::lock_guard lock(mutex_);
+        if (buffers_.empty())
+            return {};
+        auto buffer = std::move(buffers_.back());
+        buffers_.pop_back();
+        return buffer;
+    }
+
+    /// Return the buffer to the pool, e.g. the body of a processed response.
+    void give_back(std::string&& buffer) noexcept {
+        if (buffer.capacity() == 0 || buffer.capacity() > max_capacity_)
+            return;
+        buffer.clear();
+        std::lock_guard lock(mutex_);
+        if (buffers_.size() < max_count_)
+            buffers_.push_back(std::move(buffer));
+    }
+};
+
+namespace buffers {
+    /// Initial capacity of the headers block, enough for typical responses,
+    /// so it's allocated once instead of growing while headers arrive.
+    constexpr size_t HEADERS_RESERVE = 1024;
+
+    /// Upper limit of the capacity reserved up front: the size comes from the server,
+    /// a bigger body grows the buffer while it arrives.
+    constexpr size_t MAX_RESERVE = 16 * 1024 * 1024;
+
+    /// Expected ratio of the decoded to the encoded size of a compressed body
+    /// (typical for text: JSON, HTML).
+    constexpr size_t ENCODED_GROWTH = 4;
+
+    /// Does the final response (the last headers block) have a Content-Encoding?
+    static inline bool encoded(std::string_view const headers) noexcept {
+        size_t start{};
+        if (headers.size() > 4)
+            if (auto const end = headers.rfind("\r\n\r\n", headers.size() - 5); end != std::string_view::npos)
+                start = end + 4;
+        bool found{};
+        shared::for_each_token(headers.substr(start), '\n', [&found](std::string_view const line) {
+            auto const colon = line.find(':');
+            if (colon != std::string_view::npos && shared::iequals(line.substr(0, colon), "content-encoding"))
+                found = !shared::iequals(shared::trim_view(line.substr(colon + 1)), "identity");
+        });
+        return found;
+    }
+
+    /// Capacity to reserve for a body of the size announced by the server
+    /// (0 - unknown), never more than MAX_RESERVE.
+    /// A compressed body is decoded by curl, its length is only a lower bound
+    /// of the decoded size, so more is reserved for it (also within the limit).
+    static inline size_t reserve_size(curl_off_t const size, bool const encoded) noexcept {
+        if (size <= 0)
+            return 0;
+        auto const expected = static_cast<size_t>(std::min(size, static_cast<curl_off_t>(MAX_RESERVE)));
+        if (encoded)
+            return expected > MAX_RESERVE / ENCODED_GROWTH ? MAX_RESERVE : expected * ENCODED_GROWTH;
+        return expected;
+    }
+
+    /// Reserve the buffer for the whole body if its size is known
+    /// (Content-Length, or the size curl expects to download).
+    /// Called with the first chunk of the body (the headers are complete).
+    static inline void reserve_expected(CURL* const handle, std::string_view const headers, std::string& buffer) noexcept {
+        curl_off_t size{-1};
+        if (curl_easy_getinfo(handle, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &size) != CURLE_OK || size <= 0)
+            return;
+        buffer.reserve(reserve_size(size, encoded(headers)));
+    }
+}
@@ -0,0 +1,195 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "cache.h"
+#include "shared.h"
+#include <charconv>
+
+//-------------------------------------------------------------------
+/// Find the cached response of the request.
+/// Entries which are stale and can't be revalidated are removed.
+/// \param method - HTTP method of the request,
+/// \param req - the request,
+/// \return the response and its freshness, nothing on a miss.
+//-------------------------------------------------------------------
+std::optional<ResponseCache::Hit> ResponseCache::find(Method const method, Request const& req) noexcept {
+    std::lock_guard lock(mutex_);
+    auto const entry = lookup(method, req);
+    if (entry == lru_.end())
+        return {};
+
+    bool const fresh = Clock::now() < entry->expires;
+    if (!fresh && !entry->response.header("etag") && !entry->response.header("last-modified")) {
+        erase(entry);
+        return {};
+    }
+    lru_.splice(lru_.begin(), lru_, entry);
+    return Hit{entry->response, fresh};
+}
+
+//-------------------------------------------------------------------
+/// Store the response of the request if it's cacheable:
+/// 200 without 'no-store' and 'Vary: *', fresh for 'max-age' seconds
+/// (or without 'max-age' if it can be revalidated).
+/// \param method - HTTP method of the request,
+/// \param req - the request,
+/// \param response - the response, its body is made shared.
+//-------------------------------------------------------------------
+void ResponseCache::store(Method const method, Request const& req, Response& response) noexcept {
+    if (response.code() != 200)
+        return;
+    auto const ttl = lifetime(response);
+    if (!ttl)
+        return;
+    if (ttl->count() == 0 && !response.header("etag") && !response.header("last-modified"))
+        return;
+
+    std::vector<std::string> names;
+    if (auto const vary = response.header("vary")) {
+        bool any{};
+        shared::for_each_token(*vary, ',', [&](std::string_view const token) {
+            auto name = shared::to_lower(shared::trim_view(token));
+            if (name == "*")
+                any = true;
+            else if (!name.empty())
+                names.push_back(std::move(name));
+        });
+        if (any)
+            return;
+    }
+
+    response.share();
+    auto key = base_of(method, req);
+    auto const base_size = key.size();
+    append_vary(key, names, req);
+    Entry entry{std::move(key), base_size, response, Clock::now() + *ttl, 0};
+    entry.size = entry.key.size() + response.body().size() + response.headers_raw().size();
+    if (entry.size > max_bytes_)
+        return;
+
+    std::lock_guard lock(mutex_);
+    if (auto const it = index_.find(entry.key); it != index_.end())
+        erase(it->second);
+    // The last 'Vary' of the URL selects the variant on lookup.
+    auto& variants = variants_[entry.key.substr(0, base_size)];
+    variants.names = std::move(names);
+    ++variants.entries;
+    lru_.push_front(std::move(entry));
+    index_.emplace(lru_.front().key, lru_.begin());
+    bytes_ += lru_.front().size;
+    while (bytes_ > max_bytes_)
+        erase(std::prev(lru_.end()));
+}
+
+//-------------------------------------------------------------------
+/// Renew the freshness of the cached response after revalidation.
+/// \param method - HTTP method of the request,
+/// \param req - the request,
+/// \param not_modified - the '304 Not Modified' response,
+/// \return the cached response, nothing if it's gone.
+//-------------------------------------------------------------------
+std::optional<Response> ResponseCache::refresh(Method const method, Request const& req, Response const& not_modified) noexcept {
+    std::lock_guard lock(mutex_);
+    auto const entry = lookup(method, req);
+    if (entry == lru_.end())
+        return {};
+    // The 304 may update the lifetime, otherwise the stored one is used.
+    auto ttl = not_modified.header("cache-control") ? lifetime(not_modified) : lifetime(entry->response);
+    entry->expires = Clock::now() + ttl.value_or(std::chrono::seconds{});
+    lru_.splice(lru_.begin(), lru_, entry);
+    return entry->response;
+}
+
+/********************************************************************
+*                                                                   *
+*                         P R I V A T E                             *
+*                                                                   *
+********************************************************************/
+
+void ResponseCache::erase(std::list<Entry>::iterator const it) noexcept {
+    bytes_ -= it->size;
+    if (auto const variants = variants_.find(it->key.substr(0, it->base_size)); variants != variants_.end())
+        if (--variants->second.entries == 0)
+            variants_.erase(variants);
+    index_.erase(it->key);
+    lru_.erase(it);
+}
+
+/// The entry of the request (call with the lock), 'lru_.end()' if there is none.
+std::list<ResponseCache::Entry>::iterator ResponseCache::lookup(Method const method, Request const& req) noexcept {
+    auto key = base_of(method, req);
+    auto const variants = variants_.find(key);
+    if (variants == variants_.end())
+        return lru_.end();
+    append_vary(key, variants->second.names, req);
+    auto const it = index_.find(key);
+    return it == index_.end() ? lru_.end() : it->second;
+}
+
+std::string ResponseCache::base_of(Method const method, Request const& req) noexcept {
+    std::string key{method_name(method)};
+    key.append(1, ' ').append(req.url());
+    return key;
+}
+
+/// Append values of the request's headers named in 'Vary' to the key.
+void ResponseCache::append_vary(std::string& key, std::vector<std::string> const& names, Request const& req) noexcept {
+    for (auto const& name : names)
+        key.append(1, '\n').append(header_of(req, name).value_or(""));
+}
+
+/// Value of the request's header (case-insensitive name).
+std::optional<std::string_view> ResponseCache::header_of(Request const& req, std::string_view const name) noexcept {
+    for (auto const& [k, v] : req.headers())
+        if (shared::iequals(k, name))
+            return v;
+    return {};
+}
+
+std::optional<std::chrono::seconds> ResponseCache::lifetime(Response const& response) noexcept {
+    bool no_store{}, no_cache{};
+    long max_age{};
+    if (auto const control = response.header("cache-control"))
+        shared::for_each_token(*control, ',', [&](std::string_view const token) {
+            auto const directive = shared::trim_view(token);
+            if (shared::iequals(directive, "no-store"))
+                no_store = true;
+            else if (shared::iequals(directive, "no-cache"))
+                no_cache = true;
+            else if (directive.size() > 8 && shared::iequals(directive.substr(0, 8), "max-age=")) {
+                auto const value = directive.substr(8);
+                if (std::from_chars(value.data(), value.data() + value.size(), max_age).ec != std::errc{})
+                    max_age = 0;
+            }
+        });
+    if (no_store)
+        return {};
+    return std::chrono::seconds{no_cache ? 0 : std::max(max_age, 0L)};
+}
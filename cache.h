@@ -0,0 +1,114 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <list>
+#include <mutex>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <unordered_map>
+#include "method.h"
+#include "request.h"
+#include "response.h"
+
+/// Memory-bounded LRU cache of responses (private, client side).
+/// Responses are stored with shared immutable bodies and headers, a hit
+/// copies only the reference. Freshness comes from 'Cache-Control: max-age',
+/// stale entries are revalidated with 'If-None-Match'/'If-Modified-Since'.
+/// The key is the method, the URL and values of the request headers named
+/// in 'Vary', so variants of a URL are kept side by side.
+class ResponseCache {
+public:
+    using Clock = std::chrono::steady_clock;
+    /// A cached response, and whether it may be used without revalidation.
+    struct Hit {
+        Response response;
+        bool fresh;
+    };
+private:
+    struct Entry {
+        std::string key;
+        // Length of the method+URL prefix of the key.
+        size_t base_size;
+        Response response;
+        Clock::time_point expires;
+        size_t size;
+    };
+    // Header names (lower-case) of the last 'Vary' of a method+URL
+    // and the number of its entries in the cache.
+    struct Variants {
+        std::vector<std::string> names{};
+        size_t entries{};
+    };
+    size_t max_bytes_;
+    size_t bytes_{};
+    std::mutex mutex_{};
+    std::list<Entry> lru_{};     // most recently used first
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index_{};
+    std::unordered_map<std::string, Variants> variants_{};
+public:
+    /// \param max_bytes - max size of cached bodies and headers.
+    explicit ResponseCache(size_t const max_bytes = 64 * 1024 * 1024) noexcept
+            : max_bytes_{max_bytes} {}
+    ResponseCache(ResponseCache const&) = delete;
+    ResponseCache& operator=(ResponseCache const&) = delete;
+
+    /// Find the response of the request.
+    [[nodiscard]] std::optional<Hit> find(Method method, Request const& req) noexcept;
+    /// Store the response if it's cacheable (its body and headers become shared).
+    void store(Method method, Request const& req, Response& response) noexcept;
+    /// Renew the cached response after '304 Not Modified'.
+    /// \return the cached response (if it's still there).
+    [[nodiscard]] std::optional<Response> refresh(Method method, Request const& req, Response const& not_modified) noexcept;
+
+    [[nodiscard]] size_t size() noexcept {
+        std::lock_guard lock(mutex_);
+        return lru_.size();
+    }
+    void clear() noexcept {
+        std::lock_guard lock(mutex_);
+        index_.clear();
+        lru_.clear();
+        variants_.clear();
+        bytes_ = 0;
+    }
+
+private:
+    void erase(std::list<Entry>::iterator it) noexcept;
+    [[nodiscard]] std::list<Entry>::iterator lookup(Method method, Request const& req) noexcept;
+    [[nodiscard]] static std::string base_of(Method method, Request const& req) noexcept;
+    static void append_vary(std::string& key, std::vector<std::string> const& names, Request const& req) noexcept;
+    [[nodiscard]] static std::optional<std::string_view> header_of(Request const& req, std::string_view name) noexcept;
+    // Freshness lifetime from the Cache-Control header (nothing if the response must not be stored).
+    [[nodiscard]] static std::optional<std::chrono::seconds> lifetime(Response const& response) noexcept;
+};
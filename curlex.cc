@@ -30,272 +30,460 @@
 -------------------------------------------------------------------*/
 #include "curlex.h"
 #include "guard.h"
-#include <fmt/core.h>
+#include "logger.h"
+#include <atomic>
+#include <thread>
 
 //-------------------------------------------------------------------
-/// Execute GET command for the request.
-/// \param req - request to execute
-/// \return optional response with data received from the server.
+/// Execute the request with the method.
+/// \param method - HTTP method,
+/// \param req - request to execute,
+/// \param sink - optional receiver of the body chunks,
+/// \return response with data received from the server or the error.
 //-------------------------------------------------------------------
-std::optional<Response> Curlex::GET(Request const& req) const noexcept {
-    // Guarantees CURL handle reset upon exiting the function.
-    Guard guard(handle_);
-
-    auto body_buffer_ptr = set_data_buffer();
-    auto headers_buffer_ptr = set_headers_buffer();
-    struct curl_slist* const headers = set_headers_list(req.headers());
+Result<Response> Curlex::perform(Method const method, Request const& req, Sink const& sink) const noexcept {
+    if (req.invalid_json())
+        return Error{CURLE_BAD_FUNCTION_ARGUMENT, "JSON"};
+    if (cache_ && method == Method::GET && !sink)
+        return cached(method, req);
+    return execute(method, req, sink);
+}
 
-    // Set option GET.
-    if (auto err = curl_easy_setopt(handle_, CURLOPT_HTTPGET, 1); err) {
-        fmt::print(stderr, "GET.HTTPGET: {}\n", curl_easy_strerror(err));
-        return {};
+//-------------------------------------------------------------------
+/// Execute the request with the method asynchronously.
+/// \param method - HTTP method,
+/// \param req - request to execute,
+/// \param callback - called with the response (or the error) on the engine's thread.
+//-------------------------------------------------------------------
+void Curlex::async_perform(Method const method, Request req, Engine::Callback callback) const noexcept {
+    if (req.invalid_json()) {
+        callback(Error{CURLE_BAD_FUNCTION_ARGUMENT, "JSON"});
+        return;
     }
-    // Set URL.
-    if (auto err = curl_easy_setopt(handle_, CURLOPT_URL, req.url().c_str()); err) {
-        fmt::print(stderr, "GET.URL: {}\n", curl_easy_strerror(err));
-        return {};
+    if (!req.http_version())
+        req.http_version(http_version_);
+    if (auto const delay = hedge_delay(method, req)) {
+        hedged(method, std::move(req), *delay, std::move(callback));
+        return;
     }
-    // Set the verbose option if the request says so
-    if (req.is_verbose())
-        if (auto err = curl_easy_setopt(handle_, CURLOPT_VERBOSE, 1L); err) {
-            fmt::print(stderr, "GET.VERBOSE: {}\n", curl_easy_strerror(err));
-            return {};
-        }
-    // And run
-    if (auto err = curl_easy_perform(handle_); err) {
-        fmt::print(stderr, "GET.PERFORM: {}\n", curl_easy_strerror(err));
-        return {};
-    }
-    // Getting the response code sent by the server.
-    long code{};
-    if (auto err = curl_easy_getinfo(handle_, CURLINFO_RESPONSE_CODE, &code); err) {
-        fmt::print(stderr, "GET.RESPONSE_CODE: {}\n", curl_easy_strerror(err));
-        return {};
-    }
-    // Release manually memory allocated for headers if they were used.
-    if (headers)
-        curl_slist_free_all(headers);
-    // Data and header buffers should free memory automatically.
-
-    return Response(code)
-            .body(std::move(*body_buffer_ptr))
-            .headers(std::move(*headers_buffer_ptr));
+    reactor().submit(method, std::move(req), std::move(callback));
 }
 
 //-------------------------------------------------------------------
-/// Execute POST command for the request.
+/// Execute the request with the method asynchronously.
+/// \param method - HTTP method,
 /// \param req - request to execute
-/// \return optional response with data received from the server.
+/// \return future for the response or the error.
 //-------------------------------------------------------------------
-std::optional<Response> Curlex::POST(Request const& req) const noexcept {
-    // Guarantees CURL handle reset upon exiting the function.
-    Guard guard(handle_);
+std::future<Result<Response>> Curlex::async_perform(Method const method, Request req) const noexcept {
+    auto promise = std::make_shared<std::promise<Result<Response>>>();
+    auto future = promise->get_future();
+    async_perform(method, std::move(req), [promise](Result<Response> response) {
+        promise->set_value(std::move(response));
+    });
+    return future;
+}
 
-    auto body_buffer_ptr = set_data_buffer();
-    auto headers_buffer_ptr = set_headers_buffer();
-    struct curl_slist* const headers = set_headers_list(req.headers());
+//-------------------------------------------------------------------
+/// Execute the request with the method in a coroutine.
+/// \param method - HTTP method,
+/// \param req - request to execute,
+/// \return task resumed with the response (or the error) on the engine's thread.
+//-------------------------------------------------------------------
+Task<Result<Response>> Curlex::co_perform(Method const method, Request req) const {
+    // Submits the request when the coroutine is suspended,
+    // the engine's callback resumes it.
+    struct Completion {
+        Curlex const* client;
+        Method method;
+        Request req;
+        std::optional<Result<Response>> result{};
 
-    // Set option POST.
-    if (auto err = curl_easy_setopt(handle_, CURLOPT_HTTPPOST, 1); err) {
-        fmt::print(stderr, "POST.HTTPPOST: {}\n", curl_easy_strerror(err));
-        return {};
-    }
-    // Set option URL.
-    if (auto err = curl_easy_setopt(handle_, CURLOPT_URL, req.url().c_str()); err) {
-        fmt::print(stderr, "POST.URL: {}\n", curl_easy_strerror(err));
-        return {};
-    }
-    if (!req.body().empty()) {
-        if (auto err = curl_easy_setopt(handle_, CURLOPT_POSTFIELDS, req.body().c_str()); err) {
-            fmt::print(stderr, "POST.POSTFIELDS: {}\n", curl_easy_strerror(err));
-            return {};
+        bool await_ready() const noexcept {
+            return false;
         }
-    }
-
-    Data data{};
-    if (!req.data().empty()) {
-        data.ptr = req.data().c_str();
-        data.left = req.data().size();
-
-        if (auto const err = curl_easy_setopt(handle_, CURLOPT_READFUNCTION, data_reader); err) {
-            fmt::print(stderr, "POST.READFUNCTION: {}\n", curl_easy_strerror(err));
-            return {};
+        void await_suspend(std::coroutine_handle<> const awaiting) noexcept {
+            client->async_perform(method, std::move(req), [this, awaiting](Result<Response> response) {
+                result.emplace(std::move(response));
+                awaiting.resume();
+            });
         }
-        if (auto const err = curl_easy_setopt(handle_, CURLOPT_READDATA, &data); err) {
-            fmt::print(stderr, "POST.READDATA: {}\n", curl_easy_strerror(err));
-            return {};
+        Result<Response> await_resume() noexcept {
+            return std::move(*result);
         }
-//        if (auto const err = curl_easy_setopt(handle_, CURLOPT_POSTFIELDSIZE, req.data().size()); err) {
-//            fmt::print(stderr, "{}\n", curl_easy_strerror(err));
-//            return {};
-//        }
-    }
+    };
+    // A named awaiter: GCC 12 corrupts members of an aggregate temporary awaited directly.
+    Completion completion{this, method, std::move(req)};
+    co_return co_await completion;
+}
 
-    // Set the verbose option if the request says so
-    if (req.is_verbose())
-        if (auto err = curl_easy_setopt(handle_, CURLOPT_VERBOSE, 1L); err) {
-            fmt::print(stderr, "POST.VERBOSE: {}\n", curl_easy_strerror(err));
-            return {};
-        }
-    // And run
-    if (auto err = curl_easy_perform(handle_); err) {
-        fmt::print(stderr, "POST.PERFORM: {}\n", curl_easy_strerror(err));
-        return {};
-    }
-    // Getting the response code sent by the server.
-    long code{};
-    if (auto err = curl_easy_getinfo(handle_, CURLINFO_RESPONSE_CODE, &code); err) {
-        fmt::print(stderr, "POST.RESPONSE_CODE: {}\n", curl_easy_strerror(err));
-        return {};
+//-------------------------------------------------------------------
+/// Execute all requests concurrently, within the limits.
+/// \param requests - requests to execute,
+/// \param callback - called with the index of a request and its result,
+/// \param limits - max number of running requests (per host and total),
+/// \param method - HTTP method of all requests.
+//-------------------------------------------------------------------
+void Curlex::execute_batch(std::span<Request const> const requests, Batch::Callback callback,
+                           BatchLimits const limits, Method const method) const {
+    // Waiting for the engines on an engine's thread could deadlock,
+    // executing the requests there would stall all transfers of the engine.
+    if (Engine::on_loop_thread()) {
+        for (size_t i = 0; i < requests.size(); ++i)
+            callback(i, Error{CURLE_RECURSIVE_API_CALL, "BATCH"});
+        return;
     }
-    // Release manually memory allocated for headers if they were used.
-    if (headers)
-        curl_slist_free_all(headers);
-    // Data and header buffers should free memory automatically.
+    Batch batch(requests, method, limits, std::move(callback),
+                [this](Method const m, Request req, Engine::Callback cb) {
+                    async_perform(m, std::move(req), std::move(cb));
+                });
+    batch.run();
+}
 
-    return Response(code)
-            .body(std::move(*body_buffer_ptr))
-            .headers(std::move(*headers_buffer_ptr));
+//-------------------------------------------------------------------
+/// Execute all requests concurrently, within the limits.
+/// \return results in order of the requests.
+//-------------------------------------------------------------------
+std::vector<Result<Response>> Curlex::execute_batch(std::span<Request const> const requests,
+                                                    BatchLimits const limits, Method const method) const {
+    std::vector<std::optional<Result<Response>>> slots(requests.size());
+    execute_batch(requests, [&slots](size_t const index, Result<Response> result) {
+        slots[index].emplace(std::move(result));
+    }, limits, method);
+
+    std::vector<Result<Response>> results;
+    results.reserve(slots.size());
+    for (auto& slot : slots)
+        results.push_back(std::move(*slot));
+    return results;
 }
 
 //-------------------------------------------------------------------
-/// Execute OPTIONS command for the request.
-/// \param req - request to execute
-/// \return optional response with data received from the server.
+/// Execute all requests concurrently, within the limits, in a coroutine.
+/// \param requests - requests to execute,
+/// \param limits - max number of running requests (per host and total),
+/// \param method - HTTP method of all requests,
+/// \return task resumed with results in order of the requests.
 //-------------------------------------------------------------------
-std::optional<Response> Curlex::OPTIONS(Request const& req) const noexcept {
-    // Guarantees CURL handle reset upon exiting the function.
-    Guard guard(handle_);
+Task<std::vector<Result<Response>>> Curlex::co_execute_batch(std::vector<Request> requests,
+                                                             BatchLimits const limits, Method const method) const {
+    // Starts the batch when the coroutine is suspended,
+    // the last completion resumes it.
+    struct Completion {
+        Curlex const* client;
+        std::span<Request const> requests;
+        BatchLimits limits;
+        Method method;
+        std::vector<std::optional<Result<Response>>> slots{};
+        std::unique_ptr<Batch> batch{};
 
-    auto body_buffer_ptr = set_data_buffer();
-    auto headers_buffer_ptr = set_headers_buffer();
-    struct curl_slist* const headers = set_headers_list(req.headers());
+        bool await_ready() const noexcept {
+            return requests.empty();
+        }
+        void await_suspend(std::coroutine_handle<> const awaiting) {
+            slots.resize(requests.size());
+            batch = std::make_unique<Batch>(
+                    requests, method, limits,
+                    [this](size_t const index, Result<Response> result) {
+                        slots[index].emplace(std::move(result));
+                    },
+                    [client = client](Method const m, Request req, Engine::Callback cb) {
+                        client->async_perform(m, std::move(req), std::move(cb));
+                    });
+            // The resumed coroutine destroys the batch, nothing follows the start.
+            batch->start([awaiting] { awaiting.resume(); });
+        }
+        std::vector<Result<Response>> await_resume() {
+            std::vector<Result<Response>> results;
+            results.reserve(slots.size());
+            for (auto& slot : slots)
+                results.push_back(std::move(*slot));
+            return results;
+        }
+    };
+    // A named awaiter: GCC 12 corrupts members of an aggregate temporary awaited directly.
+    Completion completion{this, requests, limits, method};
+    co_return co_await completion;
+}
 
-    // Set option OPTIONS
-    if (auto err = curl_easy_setopt(handle_, CURLOPT_CUSTOMREQUEST, "OPTIONS"); err) {
-        fmt::print(stderr, "OPTIONS.CUSTOMREQUEST: {}\n", curl_easy_strerror(err));
-        return {};
+/********************************************************************
+*                                                                   *
+*                         P R I V A T E                             *
+*                                                                   *
+********************************************************************/
+
+/// Execute the request with its retry and hedging policies.
+Result<Response> Curlex::execute(Method const method, Request const& req, Sink const& sink) const noexcept {
+    // The hedge race runs on the engine; waiting for it on an engine's thread
+    // (an async callback, a coroutine resumed there) could deadlock, and a plain
+    // request there would stall the engine, so it's refused ('co_perform' hedges).
+    if (!sink && hedge_delay(method, req)) {
+        if (Engine::on_loop_thread())
+            return Error{CURLE_RECURSIVE_API_CALL, "HEDGE"};
+        return async_perform(method, req).get();
     }
-    // Set URL.
-    if (auto err = curl_easy_setopt(handle_, CURLOPT_URL, req.url().c_str()); err) {
-        fmt::print(stderr, "OPTIONS.URL: {}\n", curl_easy_strerror(err));
-        return {};
+
+    auto const start = Error::Clock::now();
+    for (int attempt = 1;; ++attempt) {
+        auto result = perform_once(method, req, sink, start);
+        if (result || !req.retry() || sink || req.upload())
+            return result;
+        auto const elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Error::Clock::now() - start);
+        auto const pause = req.retry()->next(method, attempt, result.error().code, elapsed);
+        if (!pause)
+            return result;
+        std::this_thread::sleep_for(*pause);
     }
-    // Set the verbose option if the request says so
-    if (req.is_verbose())
-        if (auto err = curl_easy_setopt(handle_, CURLOPT_VERBOSE, 1L); err) {
-            fmt::print(stderr, "OPTIONS.VERBOSE: {}\n", curl_easy_strerror(err));
-            return {};
-        }
+}
+
+/// Execute the request through the response cache: a fresh hit doesn't
+/// touch the network, a stale one is revalidated with a conditional request.
+Result<Response> Curlex::cached(Method const method, Request const& req) const noexcept {
+    auto hit = cache_->find(method, req);
+    if (hit && hit->fresh)
+        return std::move(hit->response);
+
+    if (!hit) {
+        auto result = execute(method, req, {});
+        if (result)
+            cache_->store(method, req, *result);
+        return result;
+    }
+
+    Request conditional(req);
+    if (auto const etag = hit->response.header("etag"))
+        conditional.add_header("If-None-Match", std::string(*etag), Request::Policy::Replace);
+    if (auto const modified = hit->response.header("last-modified"))
+        conditional.add_header("If-Modified-Since", std::string(*modified), Request::Policy::Replace);
+    auto result = execute(method, conditional, {});
+    if (result && result->code() == 304)
+        return cache_->refresh(method, req, *result).value_or(std::move(hit->response));
+    if (result)
+        cache_->store(method, req, *result);
+    return result;
+}
+
+/// One attempt of the request.
+/// \param start - start of the first attempt,
+/// \return response with data received from the server or the error.
+Result<Response> Curlex::perform_once(Method const method, Request const& req, Sink const& sink, Error::Clock::time_point const start) const noexcept {
+    auto const name = method_name(method);
+    // Guarantees CURL handle reset upon exiting the function
+    // (unless the handle configuration is persistent).
+    Guard guard(handle_, !persistent_);
+    Context ctx{handle_};
+    if (!configure(method, req, ctx) || !set_buffers(method, ctx, sink))
+        return ctx.error.since(start);
+
     // And run
     if (auto err = curl_easy_perform(handle_); err) {
-        fmt::print(stderr, "OPTIONS.PERFORM: {}\n", curl_easy_strerror(err));
-        return {};
+        logger::print("{}.PERFORM: {}", name, curl_easy_strerror(err));
+        if (metrics_)
+            metrics_->record_error(method, err);
+        return Error{err, "PERFORM"}.since(start);
     }
     // Getting the response code sent by the server.
     long code{};
     if (auto err = curl_easy_getinfo(handle_, CURLINFO_RESPONSE_CODE, &code); err) {
-        fmt::print(stderr, "OPTIONS.RESPONSE_CODE: {}\n", curl_easy_strerror(err));
-        return {};
+        logger::print("{}.RESPONSE_CODE: {}", name, curl_easy_strerror(err));
+        return Error{err, "RESPONSE_CODE"}.since(start);
     }
-    // Release manually memory allocated for headers if they were used.
-    if (headers)
-        curl_slist_free_all(headers);
-    // Data and header buffers should free memory automatically.
-
-    return Response(code)
-            .body(std::move(*body_buffer_ptr))
-            .headers(std::move(*headers_buffer_ptr));
+    auto stats = Transfer::stats(handle_);
+    stats.decoded = ctx.decoded;
+    if (metrics_)
+        metrics_->record(method, req.host(), code, stats);
+    // Named, so it's moved (not copied) into the result.
+    Response response(code);
+    response.body(std::move(ctx.body))
+            .headers(std::move(ctx.headers))
+            .stats(stats);
+    return response;
 }
 
-/********************************************************************
-*                                                                   *
-*                         P R I V A T E                             *
-*                                                                   *
-********************************************************************/
-
-/// Allocation and registration a buffer in the system for received
-/// body data and registration of the function for saving them.
-/// \return shared pointer to allocated memory.
-std::shared_ptr<std::string> Curlex::set_data_buffer() const noexcept {
-    if (auto err = curl_easy_setopt(handle_, CURLOPT_WRITEFUNCTION, collector); err) {
-        fmt::print(stderr, "{}\n", curl_easy_strerror(err));
+/// Delay of the duplicate, if the request should be hedged.
+std::optional<std::chrono::milliseconds> Curlex::hedge_delay(Method const method, Request const& req) const noexcept {
+    auto const& policy = req.hedge();
+    if (!policy || !idempotent(method) || req.upload())
         return {};
-    }
-    auto ptr = std::make_shared<std::string>();
-    if (auto err = curl_easy_setopt(handle_, CURLOPT_WRITEDATA, ptr.get()); err) {
-        fmt::print(stderr, "{}\n", curl_easy_strerror(err));
+    if (policy->delay.count())
+        return policy->delay;
+    if (!metrics_)
         return {};
-    }
-    return ptr;
+    if (auto const us = metrics_->recent_percentile(req.host(), policy->percentile, policy->min_samples))
+        return std::chrono::ceil<std::chrono::milliseconds>(std::chrono::microseconds(*us));
+    return {};
 }
 
-/// Allocation and registration a buffer in the system for received
-/// headers data and registration of the function for saving them.
-/// \return shared pointer to allocated memory.
-std::shared_ptr<std::string> Curlex::set_headers_buffer() const noexcept {
-    if (auto err = curl_easy_setopt(handle_, CURLOPT_HEADERFUNCTION, collector); err) {
-        fmt::print(stderr, "{}\n", curl_easy_strerror(err));
-        return {};
+/// Send the request and its duplicate after the delay, the first response wins.
+/// The other transfer is cancelled (or not started at all).
+/// If both fail, the error of the later one is delivered.
+void Curlex::hedged(Method const method, Request req, std::chrono::milliseconds const delay, Engine::Callback callback) const noexcept {
+    struct Race {
+        std::mutex mutex{};
+        int pending{2};
+        Engine::Callback callback;
+    };
+    auto const race = std::make_shared<Race>();
+    race->callback = std::move(callback);
+    auto const cancel = std::make_shared<std::atomic<bool>>(false);
+
+    auto leg = [race, cancel](Result<Response> response) {
+        Engine::Callback winner;
+        {
+            std::lock_guard lock(race->mutex);
+            --race->pending;
+            if (race->callback && (response || !race->pending))
+                winner = std::move(race->callback);
+        }
+        if (winner) {
+            cancel->store(true);
+            winner(std::move(response));
+        }
+    };
+    reactor().submit(method, req, leg, {}, cancel);
+    reactor().submit(method, std::move(req), leg, delay, cancel);
+}
+
+/// Engines of asynchronous requests, created on the first use.
+Reactor& Curlex::reactor() const {
+    std::call_once(reactor_once_, [this] {
+        reactor_ = std::make_unique<Reactor>(threads_, share_, metrics_);
+    });
+    return *reactor_;
+}
+
+/// Apply options of the request to the handle. Options which are
+/// the same as in the previous request (persistent mode) are skipped.
+/// \param method - HTTP method of the request,
+/// \param req - request to execute,
+/// \param ctx - state of the call,
+/// \return true if the handle is ready to be performed (otherwise see ctx.error).
+bool Curlex::configure(Method const method, Request const& req, Context& ctx) const noexcept {
+    auto const name = method_name(method);
+    auto setopt = [this, name, &ctx](char const* what, CURLoption option, auto value) {
+        if (auto err = curl_easy_setopt(handle_, option, value); err) {
+            logger::print("{}.{}: {}", name, what, curl_easy_strerror(err));
+            ctx.fail(err, what);
+            return false;
+        }
+        return true;
+    };
+
+    // The handle was reset (or we don't know its state) - apply everything.
+    if (!persistent_ || !applied_.valid) {
+        forget();
+        if (share_)
+            if (auto err = share_->apply(handle_); err) return ctx.fail(err, "SHARE");
+        if (!setopt("WRITEFUNCTION", CURLOPT_WRITEFUNCTION, receiver)) return false;
+        if (!setopt("HEADERFUNCTION", CURLOPT_HEADERFUNCTION, Transfer::collector)) return false;
     }
-    auto ptr = std::make_shared<std::string>();
-    if (auto err = curl_easy_setopt(handle_, CURLOPT_HEADERDATA, ptr.get()); err) {
-        fmt::print(stderr, "{}\n", curl_easy_strerror(err));
-        return {};
+    bool const fresh = !applied_.valid;
+
+    // The body options point into the request, they are set every time.
+    bool const with_body = method == Method::POST || method == Method::PUT || method == Method::PATCH;
+    if (fresh || applied_.method != method || with_body) {
+        applied_.method = {};
+        if (!Transfer::set_method(handle_, method, req, ctx.data, ctx.error)) return false;
+        applied_.method = method;
+    }
+    if (fresh || applied_.url != req.url()) {
+        if (!setopt("URL", CURLOPT_URL, req.url().c_str())) return false;
+        applied_.url = req.url();
+    }
+    // Set the verbose option if the request says so
+    if (fresh || applied_.verbose != req.is_verbose()) {
+        if (!setopt("VERBOSE", CURLOPT_VERBOSE, req.is_verbose() ? 1L : 0L)) return false;
+        applied_.verbose = req.is_verbose();
+    }
+    auto const version = req.http_version().value_or(http_version_);
+    if (fresh || applied_.http_version != version) {
+        applied_.http_version = {};
+        if (!Transfer::set_http_version(handle_, method, version, ctx.error)) return false;
+        applied_.http_version = version;
+    }
+    if (fresh || applied_.compression != req.compression()) {
+        if (!Transfer::set_encoding(handle_, method, req, ctx.error)) return false;
+        applied_.compression = req.compression();
+    }
+    if (fresh || applied_.connect_timeout != req.connect_timeout() || applied_.timeout != req.timeout()) {
+        applied_.connect_timeout = applied_.timeout = std::chrono::milliseconds(-1);
+        if (!Transfer::set_timeouts(handle_, method, req, ctx.error)) return false;
+        applied_.connect_timeout = req.connect_timeout();
+        applied_.timeout = req.timeout();
+    }
+    if (fresh || applied_.headers != req.headers()) {
+        auto const list = Transfer::headers_list(req.headers());
+        if (!setopt("HTTPHEADER", CURLOPT_HTTPHEADER, list)) {
+            if (list) curl_slist_free_all(list);
+            return false;
+        }
+        if (applied_.list)
+            curl_slist_free_all(applied_.list);
+        applied_.list = list;
+        applied_.headers = req.headers();
     }
-    return ptr;
+    applied_.valid = true;
+    return true;
 }
 
-/// Create curl's list with headers,
-/// \param headers - user defined vector of pairs key-value.
-/// \return pointer to internally allocated curl's list.
-/// \remark the memory of the list must be manually released.
-struct curl_slist* Curlex::set_headers_list(std::vector<std::pair<std::string, std::string>> const& headers) const noexcept {
-    if (headers.empty()) return {};
-    struct curl_slist* list = nullptr;
+/// Forget options applied to the handle, the next request applies all of them.
+void Curlex::forget() const noexcept {
+    if (applied_.list)
+        curl_slist_free_all(applied_.list);
+    applied_ = {};
+}
 
-    for (auto const& pair : headers) {
-        auto [k, v] = pair;
-        auto const text = fmt::format("{}:{}", k, v);
-        list = curl_slist_append(list, text.c_str());
+/// Registration of the call's buffers for received body and headers.
+/// The body buffer comes from the buffers pool if it's set.
+/// If the sink is given the body goes directly to it, and the buffer stays empty.
+/// \param method - HTTP method (HEAD has no body to collect),
+/// \param ctx - state of the call,
+/// \param sink - optional receiver of the body chunks,
+/// \return true if the buffers are registered (otherwise see ctx.error).
+bool Curlex::set_buffers(Method const method, Context& ctx, Sink const& sink) const noexcept {
+    bool const streaming = bool(sink);
+    if (applied_.streaming != streaming) {
+        if (auto err = curl_easy_setopt(handle_, CURLOPT_WRITEFUNCTION, streaming ? streamer : receiver); err) {
+            logger::print("WRITEFUNCTION: {}", curl_easy_strerror(err));
+            return ctx.fail(err, "WRITEFUNCTION");
+        }
+        applied_.streaming = streaming;
     }
-    if (auto err = curl_easy_setopt(handle_, CURLOPT_HTTPHEADER, list); err) {
-        fmt::print(stderr, "{}\n", curl_easy_strerror(err));
-        return {};
+    if (!streaming && buffers_ && method != Method::HEAD)
+        ctx.body = buffers_->take();
+
+    if (streaming)
+        ctx.sink = &sink;
+    if (auto err = curl_easy_setopt(handle_, CURLOPT_WRITEDATA, &ctx); err) {
+        logger::print("WRITEDATA: {}", curl_easy_strerror(err));
+        return ctx.fail(err, "WRITEDATA");
+    }
+    ctx.headers.reserve(buffers::HEADERS_RESERVE);
+    if (auto err = curl_easy_setopt(handle_, CURLOPT_HEADERDATA, &ctx.headers); err) {
+        logger::print("HEADERDATA: {}", curl_easy_strerror(err));
+        return ctx.fail(err, "HEADERDATA");
     }
-    return list;
+    return true;
 }
 
-
-/// A static function that adds the specified data to a buffer that is a string.
-/// \param src - pointer to the buffer with the data to be saved
-/// \param one_item_size - size of one copied item (normally 1 for bytes),
-/// \param items_count - how many itams to copy (number of bytes - one_item_size * items_count).
+/// A static function that adds the received body data to the buffer.
+/// The buffer is reserved for the expected size of the body with the first chunk.
 /// \return number of copied bytes.
-size_t Curlex::collector(char const *const src, size_t one_item_size, size_t const items_count, void *const dst) noexcept {
-    auto const string = reinterpret_cast<std::string *>(dst);
+size_t Curlex::receiver(char const* const src, size_t const one_item_size, size_t const items_count, void* const dst) noexcept {
+    auto const ctx = reinterpret_cast<Context*>(dst);
     auto const n = one_item_size * items_count;
-    string->append(src, n);
+    if (ctx->body.empty())
+        buffers::reserve_expected(ctx->handle, ctx->headers, ctx->body);
+    ctx->body.append(src, n);
+    ctx->decoded += static_cast<int64_t>(n);
     return n;
-};
-
-/// Copy data from source to destination.
-/// \param dst - copy destination,
-/// \param one_item_size - size one item in bytes (normally 1 for bytes),
-/// \param items_count - how many items to copy  (number of bytes := one_item_size * items_count),
-/// \param src - from where copy
-/// \return number of copied bytes.
-size_t Curlex::data_reader(char* const dst, size_t const one_item_size, size_t const items_count, void* const src) noexcept {
-    auto data = reinterpret_cast<struct Data*>(src);
-    size_t const max_bytes_to_copy = one_item_size * items_count;
-
-    if (data->left) {
-        auto const n = (data->left > max_bytes_to_copy) ? max_bytes_to_copy : data->left;
-        memcpy(dst, data->ptr, n);
+}
 
-        data->ptr += n;
-        data->left -= n;
-        return n;
-    }
-    return 0;
-}
\ No newline at end of file
+/// A static function that passes the received data to the user's sink.
+/// \return number of consumed bytes (0 if the sink wants to abort).
+size_t Curlex::streamer(char const* const src, size_t const one_item_size, size_t const items_count, void* const dst) noexcept {
+    auto const ctx = reinterpret_cast<Context*>(dst);
+    auto const n = one_item_size * items_count;
+    ctx->decoded += static_cast<int64_t>(n);
+    return (*ctx->sink)(std::span{src, n}) ? n : 0;
+}
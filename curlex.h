@@ -35,47 +35,281 @@
 #include <memory>
 #include <utility>
 #include <optional>
+#include <future>
+#include <mutex>
+#include <chrono>
+#include <algorithm>
 #include "version_info.h"
 #include "request.h"
 #include "response.h"
+#include "engine.h"
+#include "reactor.h"
+#include "share.h"
+#include "sink.h"
+#include "buffers.h"
+#include "metrics.h"
+#include "cache.h"
+#include "runtime.h"
+#include "batch.h"
+#include "task.h"
 
 class Curlex {
+    friend class CurlexPool;
     CURL* handle_;
-    struct Data { char const* ptr; size_t left; };
+    // Caches shared with other handles of the pool (if any).
+    std::shared_ptr<Share> share_{};
+    // State of one call, lives on the stack of the call (curl keeps pointers to it).
+    struct Context {
+        CURL* handle;
+        std::string body{};
+        std::string headers{};
+        Transfer::Data data{};
+        Error error{};
+        // Receiver of the body chunks (if any) and the number of decoded body bytes.
+        Sink const* sink{};
+        int64_t decoded{};
+        // Store the error of a failed step, returns false for convenience.
+        bool fail(CURLcode const code, char const* const stage) noexcept {
+            error.code = code;
+            error.stage = stage;
+            return false;
+        }
+    };
+    using KeyValueVec = std::vector<std::pair<std::string, std::string>>;
+    // Options applied to the handle by the previous request.
+    struct Applied {
+        bool valid{};
+        std::optional<Method> method{};
+        std::string url{};
+        bool verbose{};
+        bool compression{};
+        std::optional<HttpVersion> http_version{};
+        bool streaming{};
+        std::chrono::milliseconds connect_timeout{};
+        std::chrono::milliseconds timeout{};
+        KeyValueVec headers{};
+        struct curl_slist* list{};
+    };
+    bool persistent_{};
+    mutable Applied applied_{};
+    // Source of the body buffers (if any).
+    std::shared_ptr<BufferPool> buffers_{};
+    // Used by requests which don't select the HTTP version.
+    HttpVersion http_version_{HttpVersion::Default};
+    // Responses of GET requests (if any).
+    std::shared_ptr<ResponseCache> cache_{};
+    // Counters and histograms of the requests (if any).
+    std::shared_ptr<Metrics> metrics_{};
+    // Number of event-loop threads of asynchronous requests.
+    size_t threads_{1};
+    // Created on the first asynchronous request.
+    mutable std::once_flag reactor_once_{};
+    mutable std::unique_ptr<Reactor> reactor_{};
 public:
     Curlex() {
-        curl_global_init(CURL_GLOBAL_DEFAULT);
+        runtime::ensure();
         handle_ = curl_easy_init();
     }
     ~Curlex() {
+        reactor_.reset();
         curl_easy_cleanup(handle_);
-        curl_global_cleanup();
+        forget();
     }
 
-    [[nodiscard]] std::string version() const noexcept {
-        return VersionInfo().version();
+    [[nodiscard]] std::string const& version() const noexcept {
+        return VersionInfo::instance().version();
     }
-    [[nodiscard]] VersionInfo info() const noexcept {
-        return {};
+    [[nodiscard]] VersionInfo const& info() const noexcept {
+        return VersionInfo::instance();
     }
+    /// DNS and TLS session caches shared with other handles (of a pool), if any.
+    [[nodiscard]] std::shared_ptr<Share> const& share() const noexcept {
+        return share_;
+    }
+    /// A client with a copy of the handle and the same configuration (share,
+    /// cache, buffers, metrics, HTTP version, persistent mode, threads).
+    /// Its engines are its own, created on its first asynchronous request.
     [[nodiscard]] Curlex clone() const {
-        return Curlex(curl_easy_duphandle(handle_));
+        return Curlex(curl_easy_duphandle(handle_), *this);
+    }
+    /// Persistent handle configuration: the handle isn't reset after
+    /// a request and the next one applies only options which differ.
+    Curlex& persistent(bool const on = true) noexcept {
+        if (persistent_ && !on)
+            curl_easy_reset(handle_);
+        persistent_ = on;
+        applied_.valid = false;
+        return *this;
+    }
+    /// Take body buffers from the pool. Return them with
+    /// 'pool.give_back(std::move(response).body())' when the response is processed.
+    Curlex& buffers(std::shared_ptr<BufferPool> pool) noexcept {
+        buffers_ = std::move(pool);
+        return *this;
+    }
+    /// Cache responses of GET requests (without a sink).
+    /// The cache may be shared by many clients.
+    Curlex& cache(std::shared_ptr<ResponseCache> cache) noexcept {
+        cache_ = std::move(cache);
+        return *this;
+    }
+    /// HTTP version of requests which don't select one.
+    Curlex& http_version(HttpVersion const version) noexcept {
+        http_version_ = version;
+        return *this;
+    }
+    /// Record all requests in the metrics (may be shared by many clients).
+    /// Set it before the first asynchronous request.
+    Curlex& metrics(std::shared_ptr<Metrics> metrics) noexcept {
+        metrics_ = std::move(metrics);
+        return *this;
+    }
+    /// Number of event-loop threads running asynchronous requests, each with
+    /// its own connection cache. Set it before the first asynchronous request.
+    Curlex& threads(size_t const n) noexcept {
+        threads_ = std::max<size_t>(n, 1);
+        return *this;
     }
     void quick_exit() const {
         curl_easy_setopt(handle_, CURLOPT_QUICK_EXIT, 1L);
     }
 
-    [[nodiscard]] std::optional<Response> GET(Request const& req) const noexcept;
-    [[nodiscard]] std::optional<Response> POST(Request const& req) const noexcept;
-    [[nodiscard]] std::optional<Response> OPTIONS(Request const& req) const noexcept;
+    // If the sink is given, the body of the response is passed to it
+    // and the body of the returned response is empty.
+    // Policies of the request (timeouts, retry, hedging) are applied; requests
+    // with a sink or an upload source are neither retried nor hedged.
+    // Called on an engine's thread (in an async callback or a coroutine resumed
+    // by the engine) the request blocks that engine; a hedged one fails there
+    // (CURLE_RECURSIVE_API_CALL, stage "HEDGE"), 'co_perform' hedges it on the engine.
+    [[nodiscard]] Result<Response> perform(Method method, Request const& req, Sink const& sink = {}) const noexcept;
+
+    [[nodiscard]] Result<Response> GET(Request const& req, Sink const& sink = {}) const noexcept {
+        return perform(Method::GET, req, sink);
+    }
+    [[nodiscard]] Result<Response> POST(Request const& req, Sink const& sink = {}) const noexcept {
+        return perform(Method::POST, req, sink);
+    }
+    [[nodiscard]] Result<Response> PUT(Request const& req, Sink const& sink = {}) const noexcept {
+        return perform(Method::PUT, req, sink);
+    }
+    [[nodiscard]] Result<Response> PATCH(Request const& req, Sink const& sink = {}) const noexcept {
+        return perform(Method::PATCH, req, sink);
+    }
+    [[nodiscard]] Result<Response> DELETE(Request const& req, Sink const& sink = {}) const noexcept {
+        return perform(Method::DELETE, req, sink);
+    }
+    /// Only the headers are received, the body is not collected.
+    [[nodiscard]] Result<Response> HEAD(Request const& req) const noexcept {
+        return perform(Method::HEAD, req);
+    }
+    [[nodiscard]] Result<Response> OPTIONS(Request const& req, Sink const& sink = {}) const noexcept {
+        return perform(Method::OPTIONS, req, sink);
+    }
+
+    // Typed JSON requests: the value is serialized into the body buffer of the
+    // request and the result is parsed from the receive buffer (no copies).
+    // A status >= 400 is an error (CURLE_HTTP_RETURNED_ERROR, stage "STATUS"), so is
+    // a value which can't be serialized (CURLE_BAD_FUNCTION_ARGUMENT, stage "JSON")
+    // and a body which can't be parsed (CURLE_WEIRD_SERVER_REPLY, stage "JSON").
+    template<typename U>
+    [[nodiscard]] Result<U> get_json(Request const& req) const noexcept {
+        return from_json<U>(GET(req));
+    }
+    template<typename U, typename T>
+    [[nodiscard]] Result<U> post_json(Request req, T const& value) const noexcept {
+        return from_json<U>(POST(req.json(value)));
+    }
+    template<typename U, typename T>
+    [[nodiscard]] Result<U> put_json(Request req, T const& value) const noexcept {
+        return from_json<U>(PUT(req.json(value)));
+    }
+
+    // Asynchronous variants, executed concurrently by the engine's thread.
+    // Callbacks are called on that thread.
+    void async_perform(Method method, Request req, Engine::Callback callback) const noexcept;
+    [[nodiscard]] std::future<Result<Response>> async_perform(Method method, Request req) const noexcept;
+
+    void async_get(Request req, Engine::Callback callback) const noexcept {
+        async_perform(Method::GET, std::move(req), std::move(callback));
+    }
+    [[nodiscard]] std::future<Result<Response>> async_get(Request req) const noexcept {
+        return async_perform(Method::GET, std::move(req));
+    }
+    void async_post(Request req, Engine::Callback callback) const noexcept {
+        async_perform(Method::POST, std::move(req), std::move(callback));
+    }
+    [[nodiscard]] std::future<Result<Response>> async_post(Request req) const noexcept {
+        return async_perform(Method::POST, std::move(req));
+    }
+
+    // Coroutine variants, e.g. 'auto response = co_await cx.co_get(req);'.
+    // The request is started (on the engine) when the task is awaited, and the
+    // awaiting coroutine is resumed on the engine's thread, so only a coroutine
+    // frame waits for the response, not a thread. The client must outlive the task.
+    [[nodiscard]] Task<Result<Response>> co_perform(Method method, Request req) const;
+
+    [[nodiscard]] Task<Result<Response>> co_get(Request req) const {
+        return co_perform(Method::GET, std::move(req));
+    }
+    [[nodiscard]] Task<Result<Response>> co_post(Request req) const {
+        return co_perform(Method::POST, std::move(req));
+    }
+    [[nodiscard]] Task<Result<Response>> co_put(Request req) const {
+        return co_perform(Method::PUT, std::move(req));
+    }
+    [[nodiscard]] Task<Result<Response>> co_delete(Request req) const {
+        return co_perform(Method::DELETE, std::move(req));
+    }
+    template<typename U>
+    [[nodiscard]] Task<Result<U>> co_get_json(Request req) const {
+        co_return from_json<U>(co_await co_get(std::move(req)));
+    }
+
+    // Batches: requests run concurrently on the engines, within the limits
+    // (per host and total). The callback gets results as they complete, on the
+    // engines' threads - with threads(n > 1) it's called on many threads at once,
+    // so it must be thread-safe. The call returns when all requests are completed.
+    // Called on an engine's thread (a callback, a resumed coroutine) it would block
+    // that engine, so every request fails (CURLE_RECURSIVE_API_CALL, stage "BATCH");
+    // a coroutine awaits 'co_execute_batch' instead.
+    void execute_batch(std::span<Request const> requests, Batch::Callback callback,
+                       BatchLimits limits = {}, Method method = Method::GET) const;
+    /// Results in order of the requests.
+    [[nodiscard]] std::vector<Result<Response>> execute_batch(std::span<Request const> requests,
+                                                              BatchLimits limits = {}, Method method = Method::GET) const;
+    /// Coroutine variant, no thread waits for the batch: the awaiting coroutine
+    /// is resumed with results in order of the requests, on an engine's thread.
+    [[nodiscard]] Task<std::vector<Result<Response>>> co_execute_batch(std::vector<Request> requests,
+                                                                       BatchLimits limits = {}, Method method = Method::GET) const;
 
 private:
-    explicit Curlex(CURL* handle) : handle_{handle} {}
+    Curlex(CURL* handle, Curlex const& other)
+            : handle_{handle}, share_{other.share_}, persistent_{other.persistent_}, buffers_{other.buffers_},
+              http_version_{other.http_version_}, cache_{other.cache_}, metrics_{other.metrics_}, threads_{other.threads_} {
+    }
+    explicit Curlex(std::shared_ptr<Share> share) : Curlex() {
+        share_ = std::move(share);
+    }
+
+    [[nodiscard]] Reactor& reactor() const;
+    template<typename U>
+    [[nodiscard]] static Result<U> from_json(Result<Response> const& response) noexcept {
+        if (!response)
+            return response.error();
+        if (response->code() >= 400)
+            return Error{CURLE_HTTP_RETURNED_ERROR, "STATUS"};
+        return response->json<U>();
+    }
+    [[nodiscard]] Result<Response> execute(Method method, Request const& req, Sink const& sink) const noexcept;
+    [[nodiscard]] Result<Response> cached(Method method, Request const& req) const noexcept;
+    [[nodiscard]] Result<Response> perform_once(Method method, Request const& req, Sink const& sink, Error::Clock::time_point start) const noexcept;
+    [[nodiscard]] std::optional<std::chrono::milliseconds> hedge_delay(Method method, Request const& req) const noexcept;
+    void hedged(Method method, Request req, std::chrono::milliseconds delay, Engine::Callback callback) const noexcept;
 
-    [[nodiscard]] std::shared_ptr<std::string> set_data_buffer() const noexcept;
-    [[nodiscard]] std::shared_ptr<std::string> set_headers_buffer() const noexcept;
-    [[nodiscard]] struct curl_slist* set_headers_list(std::vector<std::pair<std::string, std::string>> const& headers) const noexcept;
+    [[nodiscard]] bool configure(Method method, Request const& req, Context& ctx) const noexcept;
+    void forget() const noexcept;
+    [[nodiscard]] bool set_buffers(Method method, Context& ctx, Sink const& sink) const noexcept;
 
-    static size_t collector(char const* src, size_t one_item_size, size_t items_count, void* dst) noexcept;
-    static size_t data_reader(char* dst, size_t one_item_size, size_t items_count, void* src) noexcept;
+    static size_t receiver(char const* src, size_t one_item_size, size_t items_count, void* dst) noexcept;
+    static size_t streamer(char const* src, size_t one_item_size, size_t items_count, void* dst) noexcept;
 };
@@ -0,0 +1,429 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "engine.h"
+#include "logger.h"
+#include "runtime.h"
+#include <array>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+namespace {
+    // Set on threads running an engine's loop.
+    thread_local bool loop_thread{};
+}
+
+Engine::Engine(std::shared_ptr<Share> share, std::shared_ptr<Metrics> metrics)
+        : multi_{(runtime::ensure(), curl_multi_init())},
+          epoll_{epoll_create1(EPOLL_CLOEXEC)},
+          wake_{eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)},
+          share_{std::move(share)}, metrics_{std::move(metrics)} {
+    // Concurrent HTTP/2 (and 3) transfers to one host share a connection.
+    if (auto err = curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX); err)
+        logger::print("Engine.PIPELINING: {}", curl_multi_strerror(err));
+    curl_multi_setopt(multi_, CURLMOPT_SOCKETFUNCTION, on_socket);
+    curl_multi_setopt(multi_, CURLMOPT_SOCKETDATA, this);
+    curl_multi_setopt(multi_, CURLMOPT_TIMERFUNCTION, on_timer);
+    curl_multi_setopt(multi_, CURLMOPT_TIMERDATA, this);
+
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = wake_;
+    if (epoll_ < 0 || wake_ < 0 || epoll_ctl(epoll_, EPOLL_CTL_ADD, wake_, &event) < 0) {
+        // Without the reactor all requests fail at once with "STOPPED".
+        logger::print("Engine.EPOLL: {}", std::strerror(errno));
+        stop_ = true;
+    }
+    thread_ = std::thread(&Engine::loop, this);
+}
+
+Engine::~Engine() {
+    stop_ = true;
+    wake();
+    if (thread_.joinable())
+        thread_.join();
+    for (auto handle : idle_)
+        curl_easy_cleanup(handle);
+    // curl may still remove its sockets from the epoll.
+    curl_multi_cleanup(multi_);
+    if (wake_ >= 0)
+        close(wake_);
+    if (epoll_ >= 0)
+        close(epoll_);
+}
+
+//-------------------------------------------------------------------
+/// Queue the request to be executed by the engine.
+/// \param method - HTTP method to use,
+/// \param req - request to execute,
+/// \param callback - called on the engine's thread with the response,
+/// \param delay - time to wait before the start,
+/// \param cancel - optional flag cancelling the request.
+//-------------------------------------------------------------------
+void Engine::submit(Method const method, Request req, Callback callback,
+                    std::chrono::milliseconds const delay, Transfer::Cancel cancel) noexcept {
+    Job job{method, std::move(req), std::move(callback), std::move(cancel)};
+    job.not_before = job.submitted + delay;
+    load_.fetch_add(1, std::memory_order_relaxed);
+    bool queued{};
+    {
+        std::lock_guard lock(mutex_);
+        // If the loop doesn't run anymore, nobody would complete the job.
+        if (!stop_) {
+            pending_.push_back(std::move(job));
+            queued = true;
+        }
+    }
+    if (queued)
+        wake();
+    else
+        fail(job, CURLE_ABORTED_BY_CALLBACK, "STOPPED");
+}
+
+//-------------------------------------------------------------------
+/// Queue the request to be executed by the engine.
+/// \param method - HTTP method to use,
+/// \param req - request to execute,
+/// \return future for the response or the error.
+//-------------------------------------------------------------------
+std::future<Result<Response>> Engine::submit(Method const method, Request req) noexcept {
+    auto promise = std::make_shared<std::promise<Result<Response>>>();
+    auto future = promise->get_future();
+    submit(method, std::move(req), [promise](Result<Response> response) {
+        promise->set_value(std::move(response));
+    });
+    return future;
+}
+
+//-------------------------------------------------------------------
+/// Is the calling thread the event-loop thread of any engine?
+/// Blocking on a request there would never complete if the request
+/// is executed by the same engine.
+//-------------------------------------------------------------------
+bool Engine::on_loop_thread() noexcept {
+    return loop_thread;
+}
+
+/********************************************************************
+*                                                                   *
+*                         P R I V A T E                             *
+*                                                                   *
+********************************************************************/
+
+/// The event loop, runs on the engine's thread.
+void Engine::loop() noexcept {
+    loop_thread = true;
+    std::array<epoll_event, 64> events{};
+
+    while (!stop_) {
+        auto timeout = adopt_pending();
+        if (deadline_) {
+            auto const wait = std::chrono::ceil<std::chrono::milliseconds>(*deadline_ - Error::Clock::now()).count();
+            timeout = std::min(timeout, static_cast<int>(std::max<int64_t>(wait, 0)));
+        }
+
+        // Sleeps until there is activity on any watched socket, curl's timer
+        // or a delayed job is due, or submit() wakes us up.
+        auto const n = epoll_wait(epoll_, events.data(), static_cast<int>(events.size()), timeout);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            logger::print("Engine.EPOLL_WAIT: {}", std::strerror(errno));
+            break;
+        }
+        bool ok{true};
+        for (int i = 0; ok && i < n; ++i) {
+            auto const& event = events[i];
+            if (event.data.fd == wake_) {
+                uint64_t count{};
+                [[maybe_unused]] auto const _ = read(wake_, &count, sizeof(count));
+                continue;
+            }
+            int mask{};
+            if (event.events & EPOLLIN) mask |= CURL_CSELECT_IN;
+            if (event.events & EPOLLOUT) mask |= CURL_CSELECT_OUT;
+            if (event.events & (EPOLLERR | EPOLLHUP)) mask |= CURL_CSELECT_ERR;
+            ok = act(event.data.fd, mask);
+        }
+        if (ok && deadline_ && *deadline_ <= Error::Clock::now()) {
+            // curl sets the next one (if needed) during the action.
+            deadline_.reset();
+            ok = act(CURL_SOCKET_TIMEOUT, 0);
+        }
+        if (!ok)
+            break;
+        complete_finished();
+    }
+    abort_all();
+}
+
+/// Wake up the loop (from any thread).
+void Engine::wake() const noexcept {
+    uint64_t const one{1};
+    [[maybe_unused]] auto const _ = write(wake_, &one, sizeof(one));
+}
+
+/// Let curl handle the socket which is ready (or its timeout).
+/// \return false if the multi handle failed.
+bool Engine::act(curl_socket_t const socket, int const mask) noexcept {
+    int running{};
+    if (auto err = curl_multi_socket_action(multi_, socket, mask, &running); err) {
+        logger::print("Engine.SOCKET_ACTION: {}", curl_multi_strerror(err));
+        return false;
+    }
+    return true;
+}
+
+/// Move the submitted jobs which are due to the multi handle,
+/// delayed ones wait in the heap until they're due.
+/// \return milliseconds until the next delayed job is due (max 1000).
+int Engine::adopt_pending() noexcept {
+    std::vector<Job> jobs;
+    {
+        std::lock_guard lock(mutex_);
+        jobs.swap(pending_);
+    }
+    auto const now = Error::Clock::now();
+    for (auto& job : jobs) {
+        if (job.not_before > now && !(job.cancel && job.cancel->load()))
+            delay(std::move(job));
+        else
+            start(job);
+    }
+
+    // Only the due jobs are popped, cancelled ones (e.g. hedges) are dropped then.
+    while (!delayed_.empty() && delayed_.front().not_before <= now) {
+        std::pop_heap(delayed_.begin(), delayed_.end(), std::greater<>{});
+        auto const job = std::move(delayed_.back().job);
+        delayed_.pop_back();
+        load_.fetch_add(1, std::memory_order_relaxed);
+        start(*job);
+    }
+
+    auto next = now + std::chrono::milliseconds(1000);
+    if (!delayed_.empty())
+        next = std::min(next, delayed_.front().not_before);
+    // Round up, so the job is due when we wake up.
+    auto const wait = std::chrono::ceil<std::chrono::milliseconds>(next - now).count();
+    return static_cast<int>(std::max<int64_t>(wait, 0));
+}
+
+/// Keep the job in the heap until its start (on the loop's thread).
+/// Until then it isn't the engine's load: a hedge leg may be cancelled long
+/// before it's due, and it's dropped only then.
+void Engine::delay(Job job) noexcept {
+    load_.fetch_sub(1, std::memory_order_relaxed);
+    auto const not_before = job.not_before;
+    delayed_.push_back({not_before, std::make_unique<Job>(std::move(job))});
+    std::push_heap(delayed_.begin(), delayed_.end(), std::greater<>{});
+}
+
+/// Start the transfer of the job, or fail it (cancelled, no handle).
+void Engine::start(Job& job) noexcept {
+    if (job.cancel && job.cancel->load()) {
+        fail(job, CURLE_ABORTED_BY_CALLBACK, "CANCELLED");
+        return;
+    }
+    auto const handle = acquire_handle();
+    if (!handle) {
+        fail(job, CURLE_FAILED_INIT, "INIT");
+        return;
+    }
+    if (share_)
+        if (auto err = share_->apply(handle); err) {
+            release_handle(handle);
+            fail(job, err, "SHARE");
+            return;
+        }
+    job.transfer = std::make_unique<Transfer>(handle, job.method, std::move(job.request), job.cancel);
+    if (!job.transfer->prepare()) {
+        auto const error = job.transfer->error();
+        job.transfer.reset();
+        release_handle(handle);
+        fail(job, error.code, error.stage);
+        return;
+    }
+    if (auto err = curl_multi_add_handle(multi_, handle); err) {
+        logger::print("Engine.ADD_HANDLE: {}", curl_multi_strerror(err));
+        job.transfer.reset();
+        release_handle(handle);
+        fail(job, CURLE_FAILED_INIT, "ADD_HANDLE");
+        return;
+    }
+    running_.emplace(handle, std::move(job));
+}
+
+/// Deliver responses of all transfers finished by curl.
+void Engine::complete_finished() noexcept {
+    int left{};
+    while (auto msg = curl_multi_info_read(multi_, &left)) {
+        if (msg->msg != CURLMSG_DONE)
+            continue;
+        auto const handle = msg->easy_handle;
+        auto const result = msg->data.result;
+        auto it = running_.find(handle);
+        if (it == running_.end())
+            continue;
+        auto job = std::move(it->second);
+        running_.erase(it);
+
+        curl_multi_remove_handle(multi_, handle);
+        auto response = job.transfer->finish(result);
+        // A cancelled transfer (the loser of a hedged request) isn't a failure.
+        if (metrics_ && !(job.cancel && job.cancel->load())) {
+            if (response)
+                metrics_->record(job.method, job.transfer->request().host(), response->code(), response->stats());
+            else
+                metrics_->record_error(job.method, response.error().code);
+        }
+        if (!response) {
+            response.error().since(job.submitted);
+            if (retry(job, response.error())) {
+                release_handle(handle);
+                continue;
+            }
+        }
+        job.transfer.reset();
+        release_handle(handle);
+        deliver(job, std::move(response));
+    }
+}
+
+/// Queue the failed job again, if its retry policy allows it.
+/// \return true if the job was queued.
+bool Engine::retry(Job& job, Error const& error) noexcept {
+    auto const& policy = job.transfer->request().retry();
+    if (!policy || (job.cancel && job.cancel->load()) || job.transfer->request().upload())
+        return false;
+    auto const elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(Error::Clock::now() - job.submitted);
+    auto const pause = policy->next(job.method, job.attempt, error.code, elapsed);
+    if (!pause)
+        return false;
+
+    job.request = job.transfer->release();
+    job.transfer.reset();
+    job.not_before = Error::Clock::now() + *pause;
+    ++job.attempt;
+    // Called on the loop's thread, its next timeout includes the job.
+    delay(std::move(job));
+    return true;
+}
+
+/// Fail all jobs that didn't finish before the engine stopped.
+void Engine::abort_all() noexcept {
+    {
+        // Jobs submitted from now on (also by the callbacks below) fail in submit().
+        std::lock_guard lock(mutex_);
+        stop_ = true;
+    }
+    for (auto& [handle, job] : running_) {
+        curl_multi_remove_handle(multi_, handle);
+        job.transfer.reset();
+        release_handle(handle);
+        fail(job, CURLE_ABORTED_BY_CALLBACK, "STOPPED");
+    }
+    running_.clear();
+
+    std::vector<Job> jobs;
+    {
+        std::lock_guard lock(mutex_);
+        jobs.swap(pending_);
+    }
+    for (auto& job : jobs)
+        fail(job, CURLE_ABORTED_BY_CALLBACK, "STOPPED");
+    auto delayed = std::move(delayed_);
+    delayed_.clear();
+    for (auto& entry : delayed) {
+        load_.fetch_add(1, std::memory_order_relaxed);
+        fail(*entry.job, CURLE_ABORTED_BY_CALLBACK, "STOPPED");
+    }
+}
+
+/// Pass the result to the job's callback, the job is completed.
+void Engine::deliver(Job& job, Result<Response> result) noexcept {
+    load_.fetch_sub(1, std::memory_order_relaxed);
+    job.callback(std::move(result));
+}
+
+/// Deliver the error to the job's callback.
+void Engine::fail(Job& job, CURLcode const code, char const* const stage) noexcept {
+    deliver(job, Error{code, stage}.since(job.submitted));
+}
+
+/// Take an easy handle from the idle ones or create a new one.
+CURL* Engine::acquire_handle() noexcept {
+    if (idle_.empty())
+        return curl_easy_init();
+    auto const handle = idle_.back();
+    idle_.pop_back();
+    return handle;
+}
+
+/// Keep the handle for the next transfer.
+void Engine::release_handle(CURL* const handle) noexcept {
+    curl_easy_reset(handle);
+    idle_.push_back(handle);
+}
+
+/// Called by curl when the socket should be watched for other events,
+/// or not at all (CURL_POLL_REMOVE).
+int Engine::on_socket(CURL*, curl_socket_t const socket, int const what, void* const engine, void*) noexcept {
+    auto const self = static_cast<Engine*>(engine);
+    if (what == CURL_POLL_REMOVE) {
+        // The socket may be already closed, the error doesn't matter.
+        epoll_ctl(self->epoll_, EPOLL_CTL_DEL, socket, nullptr);
+        return 0;
+    }
+    epoll_event event{};
+    event.data.fd = socket;
+    if (what & CURL_POLL_IN) event.events |= EPOLLIN;
+    if (what & CURL_POLL_OUT) event.events |= EPOLLOUT;
+    if (epoll_ctl(self->epoll_, EPOLL_CTL_MOD, socket, &event) < 0) {
+        if (errno != ENOENT || epoll_ctl(self->epoll_, EPOLL_CTL_ADD, socket, &event) < 0) {
+            logger::print("Engine.EPOLL_CTL: {}", std::strerror(errno));
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/// Called by curl when its timer changes (-1 removes it).
+int Engine::on_timer(CURLM*, long const timeout_ms, void* const engine) noexcept {
+    auto const self = static_cast<Engine*>(engine);
+    if (timeout_ms < 0)
+        self->deadline_.reset();
+    else
+        self->deadline_ = Error::Clock::now() + std::chrono::milliseconds(timeout_ms);
+    return 0;
+}
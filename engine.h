@@ -0,0 +1,132 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <curl/curl.h>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+#include <chrono>
+#include <functional>
+#include <optional>
+#include "transfer.h"
+#include "share.h"
+#include "metrics.h"
+
+/// Runs many transfers at once on one event-loop thread
+/// using the curl's multi interface. The loop is a socket-readiness
+/// reactor: curl tells which sockets to watch (epoll) and when its timer
+/// expires, the loop reports ready sockets with curl_multi_socket_action.
+class Engine {
+public:
+    using Callback = std::function<void(Result<Response>)>;
+private:
+    struct Job {
+        Method method;
+        Request request;
+        Callback callback;
+        Transfer::Cancel cancel{};
+        Error::Clock::time_point submitted{Error::Clock::now()};
+        // Delayed start (hedged request, retry after backoff).
+        Error::Clock::time_point not_before{};
+        int attempt{1};
+        std::unique_ptr<Transfer> transfer{};
+    };
+    // Job waiting for its start, in the min-heap by 'not_before'.
+    struct Delayed {
+        Error::Clock::time_point not_before;
+        std::unique_ptr<Job> job;
+
+        bool operator>(Delayed const& other) const noexcept {
+            return not_before > other.not_before;
+        }
+    };
+    CURLM* multi_;
+    // epoll instance of the loop and the eventfd waking it up.
+    int epoll_;
+    int wake_;
+    // When curl wants curl_multi_socket_action(CURL_SOCKET_TIMEOUT) (if at all).
+    std::optional<Error::Clock::time_point> deadline_{};
+    std::shared_ptr<Share> share_;
+    std::shared_ptr<Metrics> metrics_;
+    std::mutex mutex_{};
+    std::vector<Job> pending_{};
+    // Delayed jobs, used only by the loop's thread.
+    std::vector<Delayed> delayed_{};
+    std::unordered_map<CURL*, Job> running_{};
+    std::vector<CURL*> idle_{};
+    // Submitted requests which aren't completed yet, without delayed ones.
+    std::atomic<size_t> load_{};
+    std::atomic<bool> stop_{};
+    std::thread thread_;
+public:
+    explicit Engine(std::shared_ptr<Share> share = {}, std::shared_ptr<Metrics> metrics = {});
+    ~Engine();
+    Engine(Engine const&) = delete;
+    Engine& operator=(Engine const&) = delete;
+
+    /// Queue the request, the callback is called on the engine's thread.
+    /// The request starts after the delay, unless it's cancelled before.
+    void submit(Method method, Request req, Callback callback,
+                std::chrono::milliseconds delay = {}, Transfer::Cancel cancel = {}) noexcept;
+    /// Queue the request, the response is delivered through the future.
+    [[nodiscard]] std::future<Result<Response>> submit(Method method, Request req) noexcept;
+
+    /// Number of submitted requests which aren't completed yet. Delayed ones
+    /// (hedges, retries after backoff) count from their start.
+    [[nodiscard]] size_t load() const noexcept {
+        return load_.load(std::memory_order_relaxed);
+    }
+    /// Is the calling thread the event-loop thread of any engine
+    /// (callbacks and coroutines resumed by the engine)?
+    [[nodiscard]] static bool on_loop_thread() noexcept;
+
+private:
+    void loop() noexcept;
+    void wake() const noexcept;
+    [[nodiscard]] bool act(curl_socket_t socket, int mask) noexcept;
+    [[nodiscard]] int adopt_pending() noexcept;
+    void delay(Job job) noexcept;
+    void start(Job& job) noexcept;
+    void complete_finished() noexcept;
+    [[nodiscard]] bool retry(Job& job, Error const& error) noexcept;
+    void abort_all() noexcept;
+    void deliver(Job& job, Result<Response> result) noexcept;
+    void fail(Job& job, CURLcode code, char const* stage) noexcept;
+    [[nodiscard]] CURL* acquire_handle() noexcept;
+    void release_handle(CURL* handle) noexcept;
+
+    static int on_socket(CURL* handle, curl_socket_t socket, int what, void* engine, void* data) noexcept;
+    static int on_timer(CURLM* multi, long timeout_ms, void* engine) noexcept;
+};
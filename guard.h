@@ -33,10 +33,12 @@
 
 class Guard {
     CURL* handle_;
+    bool reset_;
 public:
-    explicit Guard(CURL* handle) : handle_{handle} {}
+    explicit Guard(CURL* handle, bool const reset = true) : handle_{handle}, reset_{reset} {}
     ~Guard() {
         // Reset the handle on exit.
-        curl_easy_reset(handle_);
+        if (reset_)
+            curl_easy_reset(handle_);
     }
 };
@@ -0,0 +1,107 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "key_index.h"
+#include "shared.h"
+#include <bit>
+
+//-------------------------------------------------------------------
+/// Find the first entry with the key.
+/// \param vec - indexed params or headers,
+/// \param key - key to find,
+/// \return position of the entry in the vector, or nothing.
+//-------------------------------------------------------------------
+std::optional<size_t> KeyIndex::find(KeyValueVec const& vec, std::string_view const key) const noexcept {
+    if (slots_.empty()) {
+        for (size_t i = 0; i < vec.size(); ++i)
+            if (equal(vec[i].first, key))
+                return i;
+        return {};
+    }
+    auto const mask = slots_.size() - 1;
+    for (auto i = hash(key) & mask;; i = (i + 1) & mask) {
+        auto const slot = slots_[i];
+        if (!slot)
+            return {};
+        if (equal(vec[slot - 1].first, key))
+            return slot - 1;
+    }
+}
+
+//-------------------------------------------------------------------
+/// Index the entry appended at the end of the vector.
+/// \param vec - indexed params or headers.
+//-------------------------------------------------------------------
+void KeyIndex::added(KeyValueVec const& vec) noexcept {
+    if (vec.size() <= LINEAR_MAX)
+        return;
+    // Keep the load under 1/2 (more entries than keys is fine, repeated keys aren't indexed).
+    if (vec.size() * 2 > slots_.size())
+        rebuild(vec);
+    else
+        insert(vec, vec.size() - 1);
+}
+
+/********************************************************************
+*                                                                   *
+*                         P R I V A T E                             *
+*                                                                   *
+********************************************************************/
+
+/// FNV-1a of the key (of its lower-case form if keys are case-insensitive).
+uint64_t KeyIndex::hash(std::string_view const key) const noexcept {
+    uint64_t h = 14695981039346656037ull;
+    for (auto const c : key) {
+        h ^= static_cast<unsigned char>(fold_ ? shared::ascii_lower(c) : c);
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+bool KeyIndex::equal(std::string_view const a, std::string_view const b) const noexcept {
+    return fold_ ? shared::iequals(a, b) : a == b;
+}
+
+/// Put the position to the first free slot of its key.
+void KeyIndex::insert(KeyValueVec const& vec, size_t const position) noexcept {
+    auto const mask = slots_.size() - 1;
+    auto i = hash(vec[position].first) & mask;
+    while (slots_[i])
+        i = (i + 1) & mask;
+    slots_[i] = static_cast<uint32_t>(position + 1);
+}
+
+/// Index all first occurrences of keys in a table twice as big as needed.
+void KeyIndex::rebuild(KeyValueVec const& vec) noexcept {
+    slots_.assign(std::bit_ceil(vec.size() * 4), 0);
+    for (size_t i = 0; i < vec.size(); ++i)
+        if (!find(vec, vec[i].first))
+            insert(vec, i);
+}
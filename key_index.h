@@ -0,0 +1,68 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <optional>
+#include <string_view>
+
+/// Flat open-addressing index of keys of a key-value vector: slots hold
+/// positions (+1) of the first occurrences, keys are hashed and compared
+/// where they are stored, so the index copies no keys. Small vectors aren't
+/// indexed at all, a linear scan of a few entries is faster (and copies of
+/// small requests allocate nothing for the index).
+class KeyIndex {
+public:
+    using KeyValueVec = std::vector<std::pair<std::string, std::string>>;
+private:
+    static constexpr size_t LINEAR_MAX = 8;
+    std::vector<uint32_t> slots_{};
+    // Keys are compared case-insensitively (header names).
+    bool fold_;
+public:
+    explicit KeyIndex(bool const fold = false) noexcept : fold_{fold} {}
+
+    /// Position of the first entry with the key (if any).
+    [[nodiscard]] std::optional<size_t> find(KeyValueVec const& vec, std::string_view key) const noexcept;
+    /// Index the last entry of the vector, the first one with its key.
+    void added(KeyValueVec const& vec) noexcept;
+    void clear() noexcept {
+        slots_.clear();
+    }
+
+private:
+    [[nodiscard]] uint64_t hash(std::string_view key) const noexcept;
+    [[nodiscard]] bool equal(std::string_view a, std::string_view b) const noexcept;
+    void insert(KeyValueVec const& vec, size_t position) noexcept;
+    void rebuild(KeyValueVec const& vec) noexcept;
+};
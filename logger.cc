@@ -0,0 +1,100 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "logger.h"
+#include <mutex>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+
+namespace logger {
+    namespace {
+        std::mutex mutex{};
+        std::shared_ptr<Writer const> current = std::make_shared<Writer const>([](std::string_view const message) {
+            fmt::print(stderr, "{}\n", message);
+        });
+
+        std::atomic<size_t> per_second{10};
+        std::atomic<int64_t> window{};      // second of the current window
+        std::atomic<size_t> written{};      // in the current window
+        std::atomic<size_t> dropped{};      // in the current window
+
+        std::shared_ptr<Writer const> get() noexcept {
+            std::lock_guard lock(mutex);
+            return current;
+        }
+    }
+
+    void writer(Writer w) noexcept {
+        auto next = w ? std::make_shared<Writer const>(std::move(w)) : nullptr;
+        std::lock_guard lock(mutex);
+        current = std::move(next);
+    }
+
+    void limit(size_t const n) noexcept {
+        per_second = n;
+    }
+
+    //-------------------------------------------------------------------
+    /// Count the message in the current one-second window.
+    /// \return true if the message may be written.
+    //-------------------------------------------------------------------
+    bool admit() noexcept {
+        auto const max = per_second.load(std::memory_order_relaxed);
+        if (!max)
+            return true;
+
+        auto const now = std::chrono::duration_cast<std::chrono::seconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        auto last = window.load(std::memory_order_relaxed);
+        if (now != last && window.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+            // This thread opened the new window.
+            written.store(0, std::memory_order_relaxed);
+            if (auto const n = dropped.exchange(0, std::memory_order_relaxed))
+                write(fmt::format("logger: {} message(s) suppressed", n));
+        }
+        if (written.fetch_add(1, std::memory_order_relaxed) < max)
+            return true;
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    void write(std::string_view const message) noexcept {
+        if (auto const w = get()) {
+            try {
+                (*w)(message);
+            }
+            catch (...) {
+                // A failing writer must not break the transfer.
+            }
+        }
+    }
+}
@@ -0,0 +1,62 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <string>
+#include <utility>
+#include <functional>
+#include <string_view>
+#include <fmt/core.h>
+
+/// Diagnostic messages of the library. Messages go to a pluggable
+/// writer (stderr by default) and are rate-limited, so a storm of failures
+/// doesn't serialize threads on the writer. Messages over the limit are
+/// dropped and their number is reported when the next second starts.
+namespace logger {
+    using Writer = std::function<void(std::string_view)>;
+
+    /// Replace the writer (an empty one discards all messages).
+    /// The writer may be called from many threads at once.
+    void writer(Writer w) noexcept;
+    /// Max number of messages written per second (0 - no limit, default 10).
+    void limit(size_t per_second) noexcept;
+
+    /// Check the rate limit, true if the message may be written.
+    [[nodiscard]] bool admit() noexcept;
+    /// Write the message (without checking the limit).
+    void write(std::string_view message) noexcept;
+
+    /// Format and write the message, if the rate limit admits it.
+    template<typename... Args>
+    void print(fmt::format_string<Args...> format, Args&&... args) noexcept {
+        if (admit())
+            write(fmt::format(format, std::forward<Args>(args)...));
+    }
+}
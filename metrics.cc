@@ -0,0 +1,354 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "metrics.h"
+#include <bit>
+#include <limits>
+#include <functional>
+
+// Unique ids let threads cache their shards per Metrics object.
+static std::atomic<uint64_t> next_metrics_id{1};
+
+std::string MetricsSnapshot::as_json() const {
+    auto json = glz::write_json(this).value_or("glaze error");
+    return glz::prettify_json(json);
+}
+
+Metrics::Metrics() : id_{next_metrics_id.fetch_add(1)}, registry_{std::make_shared<Registry>()} {
+}
+
+Metrics::Shard::~Shard() {
+    for (auto& slot : hosts)
+        delete slot.load();
+}
+
+//-------------------------------------------------------------------
+/// Record a request which received a response.
+/// \param method - HTTP method of the request,
+/// \param host - host (with port) the request was sent to,
+/// \param code - HTTP status code,
+/// \param stats - statistics of the transfer.
+//-------------------------------------------------------------------
+void Metrics::record(Method const method, std::string_view const host, long const code, Stats const& stats) noexcept {
+    auto& s = shard();
+    add(s.requests[static_cast<size_t>(method)], 1);
+    add(s.status[(code >= 100 && code < 600) ? code / 100 - 1 : CLASSES - 1], 1);
+    add(s.uploaded, stats.uploaded);
+    add(s.downloaded, stats.downloaded);
+    add(s.decoded, stats.decoded);
+    add(stats.reused ? s.connections_reused : s.connections_new, 1);
+
+    auto& latency = host_of(s, host).latency;
+    add(latency.buckets[bucket_of(stats.total_us)], 1);
+    add(latency.sum, stats.total_us);
+    // Only this thread writes to the shard.
+    if (stats.total_us > latency.max.load(std::memory_order_relaxed))
+        latency.max.store(stats.total_us, std::memory_order_relaxed);
+}
+
+//-------------------------------------------------------------------
+/// Record a request which failed before getting a response.
+/// \param method - HTTP method of the request,
+/// \param error - the error reported by curl.
+//-------------------------------------------------------------------
+void Metrics::record_error(Method const method, CURLcode const error) noexcept {
+    auto& s = shard();
+    add(s.requests[static_cast<size_t>(method)], 1);
+    if (error > CURLE_OK && error < CURL_LAST)
+        add(s.errors[error], 1);
+}
+
+//-------------------------------------------------------------------
+/// Sum all shards.
+/// \return current state of the metrics.
+//-------------------------------------------------------------------
+MetricsSnapshot Metrics::snapshot() const {
+    auto const get = [](std::atomic<uint64_t> const& counter) {
+        return counter.load(std::memory_order_relaxed);
+    };
+    static constexpr char const* classes[CLASSES] = {"1xx", "2xx", "3xx", "4xx", "5xx", "other"};
+
+    MetricsSnapshot snapshot{};
+    std::array<uint64_t, METHODS> requests{};
+    std::array<uint64_t, CLASSES> status{};
+    std::array<uint64_t, CURL_LAST> errors{};
+    struct Merged {
+        std::array<uint64_t, BUCKETS> buckets{};
+        uint64_t sum{};
+        int64_t max{};
+    };
+    std::map<std::string, Merged> hosts;
+
+    auto const add_shard = [&](Shard const& shard) {
+        for (size_t i = 0; i < METHODS; ++i) requests[i] += get(shard.requests[i]);
+        for (size_t i = 0; i < CLASSES; ++i) status[i] += get(shard.status[i]);
+        for (size_t i = 0; i < CURL_LAST; ++i) errors[i] += get(shard.errors[i]);
+        snapshot.uploaded += get(shard.uploaded);
+        snapshot.downloaded += get(shard.downloaded);
+        snapshot.decoded += get(shard.decoded);
+        snapshot.connections_new += get(shard.connections_new);
+        snapshot.connections_reused += get(shard.connections_reused);
+
+        for (auto const& slot : shard.hosts) {
+            auto const host = slot.load(std::memory_order_acquire);
+            if (!host) continue;
+            auto& merged = hosts[host->name];
+            for (size_t i = 0; i < BUCKETS; ++i)
+                merged.buckets[i] += get(host->latency.buckets[i]);
+            merged.sum += get(host->latency.sum);
+            merged.max = std::max(merged.max, host->latency.max.load(std::memory_order_relaxed));
+        }
+    };
+    {
+        std::lock_guard lock(registry_->mutex);
+        for (auto const& shard : registry_->shards)
+            add_shard(*shard);
+        add_shard(registry_->retired);
+    }
+
+    for (size_t i = 0; i < METHODS; ++i)
+        if (requests[i]) snapshot.requests[method_name(static_cast<Method>(i))] = requests[i];
+    for (size_t i = 0; i < CLASSES; ++i)
+        if (status[i]) snapshot.status[classes[i]] = status[i];
+    for (size_t i = 0; i < CURL_LAST; ++i)
+        if (errors[i]) snapshot.errors[curl_easy_strerror(static_cast<CURLcode>(i))] = errors[i];
+    if (auto const total = snapshot.connections_new + snapshot.connections_reused; total)
+        snapshot.reuse_ratio = double(snapshot.connections_reused) / double(total);
+
+    for (auto const& [name, merged] : hosts) {
+        LatencySummary summary{};
+        for (auto const n : merged.buckets)
+            summary.count += n;
+        if (!summary.count) continue;
+        summary.mean_us = double(merged.sum) / double(summary.count);
+        summary.max_us = merged.max;
+
+        auto percentile = [&merged, count = summary.count](double const p) {
+            return percentile_of(merged.buckets, count, p);
+        };
+        summary.min_us = percentile(0.0);
+        summary.p50_us = percentile(0.5);
+        summary.p90_us = percentile(0.9);
+        summary.p99_us = percentile(0.99);
+        summary.p999_us = percentile(0.999);
+        snapshot.hosts[name] = summary;
+    }
+    return snapshot;
+}
+
+//-------------------------------------------------------------------
+/// Latency percentile of the host from all shards.
+/// \param host - host (with port) as in requests,
+/// \param p - the percentile (0.0 - 1.0),
+/// \param min_samples - min number of recorded requests,
+/// \return lower bound of the percentile's bucket in microseconds.
+//-------------------------------------------------------------------
+std::optional<int64_t> Metrics::percentile(std::string_view const host, double const p, uint64_t const min_samples) const {
+    std::array<uint64_t, BUCKETS> buckets{};
+    uint64_t count{};
+    auto const add_shard = [&](Shard const& shard) {
+        for (auto const& slot : shard.hosts)
+            if (auto const h = slot.load(std::memory_order_acquire); h && h->name == host)
+                for (size_t i = 0; i < BUCKETS; ++i) {
+                    auto const n = h->latency.buckets[i].load(std::memory_order_relaxed);
+                    buckets[i] += n;
+                    count += n;
+                }
+    };
+    {
+        std::lock_guard lock(registry_->mutex);
+        for (auto const& shard : registry_->shards)
+            add_shard(*shard);
+        add_shard(registry_->retired);
+    }
+    if (!count || count < min_samples)
+        return {};
+    return percentile_of(buckets, count, p);
+}
+
+//-------------------------------------------------------------------
+/// Latency percentile of the host, cached by the calling thread.
+/// \param host - host (with port) as in requests,
+/// \param p - the percentile (0.0 - 1.0),
+/// \param min_samples - min number of recorded requests,
+/// \return the percentile at most PERCENTILE_REFRESH old.
+//-------------------------------------------------------------------
+std::optional<int64_t> Metrics::recent_percentile(std::string_view const host, double const p, uint64_t const min_samples) const {
+    using Clock = std::chrono::steady_clock;
+    struct Cached {
+        uint64_t id;
+        std::string host;
+        double p;
+        uint64_t min_samples;
+        std::optional<int64_t> value;
+        Clock::time_point expires;
+    };
+    // Entries of registries which are gone are dropped with the rest when it's full.
+    static constexpr size_t MAX_CACHED = 256;
+    thread_local std::vector<Cached> cache{};
+
+    auto const now = Clock::now();
+    for (auto& entry : cache)
+        if (entry.id == id_ && entry.host == host && entry.p == p && entry.min_samples == min_samples) {
+            if (now >= entry.expires) {
+                entry.value = percentile(host, p, min_samples);
+                entry.expires = now + PERCENTILE_REFRESH;
+            }
+            return entry.value;
+        }
+    if (cache.size() >= MAX_CACHED)
+        cache.clear();
+    auto const value = percentile(host, p, min_samples);
+    cache.push_back({id_, std::string(host), p, min_samples, value, now + PERCENTILE_REFRESH});
+    return value;
+}
+
+size_t Metrics::shards() const {
+    std::lock_guard lock(registry_->mutex);
+    return registry_->shards.size();
+}
+
+/********************************************************************
+*                                                                   *
+*                         P R I V A T E                             *
+*                                                                   *
+********************************************************************/
+
+/// Shard of the calling thread, created on the first use.
+Metrics::Shard& Metrics::shard() noexcept {
+    struct Cached {
+        uint64_t id;
+        Shard* shard;
+        std::weak_ptr<Registry> registry;
+    };
+    // Shards of this thread, retired when the thread exits.
+    struct Shards {
+        std::vector<Cached> entries{};
+        ~Shards() {
+            for (auto const& entry : entries)
+                if (auto const registry = entry.registry.lock())
+                    retire(*registry, entry.shard);
+        }
+    };
+    thread_local Shards cache{};
+    for (auto const& entry : cache.entries)
+        if (entry.id == id_)
+            return *entry.shard;
+
+    // A new registry for this thread, forget the ones which are gone
+    // (long-lived threads outlive many short-lived clients).
+    std::erase_if(cache.entries, [](Cached const& entry) { return entry.registry.expired(); });
+    std::lock_guard lock(registry_->mutex);
+    auto const shard = registry_->shards.emplace_back(std::make_unique<Shard>()).get();
+    cache.entries.push_back({id_, shard, registry_});
+    return *shard;
+}
+
+/// Fold the shard of an exiting thread into the retired one and release it.
+void Metrics::retire(Registry& registry, Shard* const shard) noexcept {
+    auto const move = [](std::atomic<uint64_t>& to, std::atomic<uint64_t> const& from) {
+        add(to, from.load(std::memory_order_relaxed));
+    };
+    std::lock_guard lock(registry.mutex);
+    auto& retired = registry.retired;
+    for (size_t i = 0; i < METHODS; ++i) move(retired.requests[i], shard->requests[i]);
+    for (size_t i = 0; i < CLASSES; ++i) move(retired.status[i], shard->status[i]);
+    for (size_t i = 0; i < CURL_LAST; ++i) move(retired.errors[i], shard->errors[i]);
+    move(retired.uploaded, shard->uploaded);
+    move(retired.downloaded, shard->downloaded);
+    move(retired.decoded, shard->decoded);
+    move(retired.connections_new, shard->connections_new);
+    move(retired.connections_reused, shard->connections_reused);
+
+    // Only threads retiring a shard (with the lock) write to the retired one.
+    for (auto const& slot : shard->hosts) {
+        auto const host = slot.load(std::memory_order_relaxed);
+        if (!host) continue;
+        auto& latency = host_of(retired, host->name).latency;
+        for (size_t i = 0; i < BUCKETS; ++i)
+            move(latency.buckets[i], host->latency.buckets[i]);
+        move(latency.sum, host->latency.sum);
+        if (auto const max = host->latency.max.load(std::memory_order_relaxed); max > latency.max.load(std::memory_order_relaxed))
+            latency.max.store(max, std::memory_order_relaxed);
+    }
+    std::erase_if(registry.shards, [shard](std::unique_ptr<Shard> const& s) { return s.get() == shard; });
+}
+
+/// Find (or add) the host in the shard's table.
+/// If the table is full, the last slot collects all other hosts.
+Metrics::Host& Metrics::host_of(Shard& shard, std::string_view const name) noexcept {
+    auto const start = std::hash<std::string_view>{}(name) % MAX_HOSTS;
+    for (size_t i = 0; i < MAX_HOSTS; ++i) {
+        auto& slot = shard.hosts[(start + i) % MAX_HOSTS];
+        auto host = slot.load(std::memory_order_relaxed);
+        if (!host) {
+            host = new Host{std::string(name)};
+            slot.store(host, std::memory_order_release);
+            return *host;
+        }
+        if (host->name == name)
+            return *host;
+    }
+    auto& other = shard.hosts[MAX_HOSTS];
+    if (auto host = other.load(std::memory_order_relaxed))
+        return *host;
+    auto const host = new Host{"other"};
+    other.store(host, std::memory_order_release);
+    return *host;
+}
+
+/// Index of the bucket for the value (microseconds).
+size_t Metrics::bucket_of(int64_t const value) noexcept {
+    auto const v = static_cast<uint64_t>(std::max<int64_t>(value, 0));
+    if (v < (1u << SUB_BITS))
+        return v;
+    auto const exponent = std::bit_width(v) - 1;
+    auto const sub = (v >> (exponent - SUB_BITS)) & ((1u << SUB_BITS) - 1);
+    return std::min<size_t>(((exponent - SUB_BITS + 1) << SUB_BITS) + sub, BUCKETS - 1);
+}
+
+/// Value of the percentile in the histogram with 'count' samples.
+int64_t Metrics::percentile_of(std::array<uint64_t, BUCKETS> const& buckets, uint64_t const count, double const p) noexcept {
+    auto const rank = static_cast<uint64_t>(p * double(count - 1)) + 1;
+    uint64_t seen{};
+    for (size_t i = 0; i < BUCKETS; ++i)
+        if ((seen += buckets[i]) >= rank)
+            return value_of(i);
+    return value_of(BUCKETS - 1);
+}
+
+/// The lowest value of the bucket.
+int64_t Metrics::value_of(size_t const bucket) noexcept {
+    if (bucket < (1u << SUB_BITS))
+        return static_cast<int64_t>(bucket);
+    auto const exponent = (bucket >> SUB_BITS) + SUB_BITS - 1;
+    auto const sub = bucket & ((1u << SUB_BITS) - 1);
+    return static_cast<int64_t>(((1ull << SUB_BITS) | sub) << (exponent - SUB_BITS));
+}
@@ -0,0 +1,184 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <curl/curl.h>
+#include <map>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <optional>
+#include <vector>
+#include <string_view>
+#include <glaze/glaze.hpp>
+#include "transfer.h"
+
+/// Latency distribution of requests to one host.
+struct LatencySummary {
+    uint64_t count{};
+    double mean_us{};
+    int64_t min_us{};
+    int64_t p50_us{};
+    int64_t p90_us{};
+    int64_t p99_us{};
+    int64_t p999_us{};
+    int64_t max_us{};
+
+    struct glaze {
+        using T = LatencySummary;
+        static constexpr auto value = glz::object(
+                &T::count,
+                &T::mean_us,
+                &T::min_us,
+                &T::p50_us,
+                &T::p90_us,
+                &T::p99_us,
+                &T::p999_us,
+                &T::max_us
+        );
+    };
+};
+
+/// Aggregated state of the metrics at some moment.
+struct MetricsSnapshot {
+    std::map<std::string, uint64_t> requests{};     // by method
+    std::map<std::string, uint64_t> status{};       // by status class (2xx, ...)
+    std::map<std::string, uint64_t> errors{};       // by CURLcode
+    uint64_t uploaded{};                            // bytes
+    uint64_t downloaded{};                          // bytes (compressed)
+    uint64_t decoded{};                             // bytes after content decoding
+    uint64_t connections_new{};
+    uint64_t connections_reused{};
+    double reuse_ratio{};
+    std::map<std::string, LatencySummary> hosts{};
+
+    struct glaze {
+        using T = MetricsSnapshot;
+        static constexpr auto value = glz::object(
+                &T::requests,
+                &T::status,
+                &T::errors,
+                &T::uploaded,
+                &T::downloaded,
+                &T::decoded,
+                &T::connections_new,
+                &T::connections_reused,
+                &T::reuse_ratio,
+                &T::hosts
+        );
+    };
+
+    [[nodiscard]] std::string as_json() const;
+};
+
+/// Client-wide counters and latency histograms.
+/// Every thread records into its own shard with relaxed atomic
+/// operations (no locks, no shared cache lines); 'snapshot()' sums the shards.
+/// Shards of exited threads are folded into one and released.
+class Metrics {
+    static constexpr size_t METHODS = static_cast<size_t>(Method::OPTIONS) + 1;
+    static constexpr size_t CLASSES = 6;            // 1xx-5xx and others
+    static constexpr size_t MAX_HOSTS = 64;         // per shard, the rest goes to 'other'
+    // Log-linear (HDR-like) buckets: 16 sub-buckets per power of two (~6% precision).
+    static constexpr int SUB_BITS = 4;
+    static constexpr size_t BUCKETS = (41 - SUB_BITS + 1) << SUB_BITS;
+
+    struct Histogram {
+        std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+        std::atomic<uint64_t> sum{};
+        std::atomic<int64_t> max{};
+    };
+    struct Host {
+        std::string name;
+        Histogram latency{};
+    };
+    struct Shard {
+        std::array<std::atomic<uint64_t>, METHODS> requests{};
+        std::array<std::atomic<uint64_t>, CLASSES> status{};
+        std::array<std::atomic<uint64_t>, CURL_LAST> errors{};
+        std::atomic<uint64_t> uploaded{};
+        std::atomic<uint64_t> downloaded{};
+        std::atomic<uint64_t> decoded{};
+        std::atomic<uint64_t> connections_new{};
+        std::atomic<uint64_t> connections_reused{};
+        // Open addressing table, slots are written only by the owner thread.
+        std::array<std::atomic<Host*>, MAX_HOSTS + 1> hosts{};
+        ~Shard();
+    };
+
+    // Shards of the threads; threads keep it alive while they fold their shards
+    // into 'retired' on exit, and drop their cached shards when it's gone.
+    struct Registry {
+        std::mutex mutex{};
+        std::vector<std::unique_ptr<Shard>> shards{};
+        Shard retired{};
+    };
+    // Max age of a percentile cached by a thread.
+    static constexpr std::chrono::milliseconds PERCENTILE_REFRESH{100};
+
+    uint64_t const id_;
+    std::shared_ptr<Registry> registry_;
+public:
+    Metrics();
+    Metrics(Metrics const&) = delete;
+    Metrics& operator=(Metrics const&) = delete;
+
+    /// Record a completed request (any status code).
+    void record(Method method, std::string_view host, long code, Stats const& stats) noexcept;
+    /// Record a request failed by curl.
+    void record_error(Method method, CURLcode error) noexcept;
+
+    [[nodiscard]] MetricsSnapshot snapshot() const;
+    /// Latency percentile of the host (microseconds),
+    /// nothing if there are fewer samples than required.
+    [[nodiscard]] std::optional<int64_t> percentile(std::string_view host, double p, uint64_t min_samples = 1) const;
+    /// Like 'percentile', but computed at most every PERCENTILE_REFRESH on each
+    /// thread, so a hot path (hedging) doesn't lock and merge the shards every time.
+    [[nodiscard]] std::optional<int64_t> recent_percentile(std::string_view host, double p, uint64_t min_samples = 1) const;
+    /// Number of shards of threads which recorded and are still running.
+    [[nodiscard]] size_t shards() const;
+    [[nodiscard]] std::string as_json() const {
+        return snapshot().as_json();
+    }
+
+private:
+    [[nodiscard]] Shard& shard() noexcept;
+    static void retire(Registry& registry, Shard* shard) noexcept;
+    [[nodiscard]] static Host& host_of(Shard& shard, std::string_view name) noexcept;
+    [[nodiscard]] static size_t bucket_of(int64_t value) noexcept;
+    [[nodiscard]] static int64_t value_of(size_t bucket) noexcept;
+    [[nodiscard]] static int64_t percentile_of(std::array<uint64_t, BUCKETS> const& buckets, uint64_t count, double p) noexcept;
+    static void add(std::atomic<uint64_t>& counter, uint64_t value) noexcept {
+        counter.fetch_add(value, std::memory_order_relaxed);
+    }
+};
@@ -0,0 +1,83 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "policy.h"
+#include <random>
+#include <algorithm>
+
+using std::chrono::milliseconds;
+
+//-------------------------------------------------------------------
+/// Check if the failed attempt may be repeated.
+/// \param method - HTTP method of the request,
+/// \param attempt - number of the failed attempt (from 1),
+/// \param code - error of the attempt,
+/// \param elapsed - time since the first attempt started,
+/// \return backoff before the next attempt, nothing if there is no next attempt.
+//-------------------------------------------------------------------
+std::optional<milliseconds> RetryPolicy::next(Method const method, int const attempt, CURLcode const code, milliseconds const elapsed) const noexcept {
+    if (attempt >= attempts || !retryable(code))
+        return {};
+    if (!non_idempotent && !idempotent(method))
+        return {};
+    auto const pause = delay(attempt);
+    if (budget.count() && elapsed + pause >= budget)
+        return {};
+    return pause;
+}
+
+milliseconds RetryPolicy::delay(int const attempt) const noexcept {
+    thread_local std::minstd_rand generator{std::random_device{}()};
+    auto const exponent = std::min(attempt - 1, 30);
+    auto const ceiling = std::min<int64_t>(max_backoff.count(), backoff.count() << exponent);
+    if (ceiling <= 0)
+        return {};
+    return milliseconds{std::uniform_int_distribution<int64_t>(0, ceiling - 1)(generator)};
+}
+
+bool RetryPolicy::retryable(CURLcode const code) noexcept {
+    switch (code) {
+        case CURLE_COULDNT_RESOLVE_HOST:
+        case CURLE_COULDNT_CONNECT:
+        case CURLE_OPERATION_TIMEDOUT:
+        case CURLE_SSL_CONNECT_ERROR:
+        case CURLE_SEND_ERROR:
+        case CURLE_RECV_ERROR:
+        case CURLE_GOT_NOTHING:
+        case CURLE_PARTIAL_FILE:
+        case CURLE_HTTP2:
+        case CURLE_HTTP2_STREAM:
+        case CURLE_HTTP3:
+        case CURLE_QUIC_CONNECT_ERROR:
+            return true;
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,69 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <curl/curl.h>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include "method.h"
+
+/// Retry of failed requests with exponential backoff and full jitter.
+/// Only transport errors which may be transient are retried,
+/// and (by default) only idempotent methods.
+struct RetryPolicy {
+    // Max number of attempts (1 - no retries).
+    int attempts{3};
+    // Backoff before the n-th retry is a random value from [0, min(max_backoff, backoff * 2^n)).
+    std::chrono::milliseconds backoff{100};
+    std::chrono::milliseconds max_backoff{2000};
+    // Time for all attempts, no retry is started after it (0 - no limit).
+    std::chrono::milliseconds budget{};
+    // Retry also POST and PATCH.
+    bool non_idempotent{};
+
+    /// Backoff before the next attempt, if the failed one may be repeated.
+    [[nodiscard]] std::optional<std::chrono::milliseconds> next(Method method, int attempt, CURLcode code, std::chrono::milliseconds elapsed) const noexcept;
+    /// Random backoff before the retry after the attempt.
+    [[nodiscard]] std::chrono::milliseconds delay(int attempt) const noexcept;
+    /// Transient errors (connection problems, timeouts, broken transfers).
+    [[nodiscard]] static bool retryable(CURLcode code) noexcept;
+};
+
+/// Hedged requests: if there is no response after the delay, a duplicate
+/// of the request is sent and the first response wins (the other transfer is cancelled).
+/// Only idempotent requests without a sink and an upload source are hedged.
+struct HedgePolicy {
+    // Fixed delay (0 - the percentile of the host's latency from the client's metrics).
+    std::chrono::milliseconds delay{};
+    double percentile{0.95};
+    // Min number of the host's samples for the percentile delay.
+    uint64_t min_samples{20};
+};
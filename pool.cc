@@ -0,0 +1,89 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "pool.h"
+#include "runtime.h"
+
+CurlexPool::CurlexPool(size_t const capacity, long const max_idle, long const max_idle_age)
+        : state_{std::make_shared<State>(capacity)}
+{
+    runtime::ensure();
+    share_ = std::make_shared<Share>(max_idle, max_idle_age);
+}
+
+/// Idle handles are released now, leased ones when their leases end.
+CurlexPool::~CurlexPool() {
+    std::vector<std::unique_ptr<Curlex>> idle;
+    {
+        std::lock_guard lock(state_->mutex);
+        state_->closed = true;
+        idle.swap(state_->idle);
+    }
+}
+
+//-------------------------------------------------------------------
+/// Take an idle handle from the pool or create a new one.
+/// If the capacity of the pool is reached, waits for a returned handle.
+/// \return lease of the handle.
+//-------------------------------------------------------------------
+CurlexPool::Lease CurlexPool::lease() {
+    auto& state = *state_;
+    std::unique_lock lock(state.mutex);
+    if (state.capacity)
+        state.returned.wait(lock, [&state] { return state.leased < state.capacity; });
+    ++state.leased;
+
+    if (!state.idle.empty()) {
+        auto cx = std::move(state.idle.back());
+        state.idle.pop_back();
+        return {state_, std::move(cx)};
+    }
+    lock.unlock();
+    auto cx = std::unique_ptr<Curlex>(new Curlex(share_));
+    cx->metrics(metrics_);
+    return {state_, std::move(cx)};
+}
+
+/********************************************************************
+*                                                                   *
+*                         P R I V A T E                             *
+*                                                                   *
+********************************************************************/
+
+/// Keep the returned handle for the next lease, release it if the pool is gone.
+void CurlexPool::State::give_back(std::unique_ptr<Curlex> cx) noexcept {
+    {
+        std::lock_guard lock(mutex);
+        --leased;
+        if (!closed)
+            idle.push_back(std::move(cx));
+    }
+    returned.notify_one();
+}
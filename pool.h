@@ -0,0 +1,99 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <condition_variable>
+#include "curlex.h"
+#include "share.h"
+#include "metrics.h"
+
+/// Thread-safe pool of Curlex objects. Pooled handles share the DNS cache
+/// and the TLS session cache, so a new connection to a known host skips the
+/// lookup and resumes the TLS session. Connections are kept per handle (libcurl
+/// doesn't support sharing them by threads), the most recently returned handle
+/// is leased first, so hot endpoints reuse its open connections.
+class CurlexPool {
+    // Handles of the pool, kept alive by leases which outlive the pool.
+    struct State {
+        size_t capacity;
+        size_t leased{};
+        bool closed{};
+        std::vector<std::unique_ptr<Curlex>> idle{};
+        std::mutex mutex{};
+        std::condition_variable returned{};
+
+        void give_back(std::unique_ptr<Curlex> cx) noexcept;
+    };
+    std::shared_ptr<Share> share_;
+    // Shared by all pooled handles.
+    std::shared_ptr<Metrics> metrics_{std::make_shared<Metrics>()};
+    std::shared_ptr<State> state_;
+public:
+    /// Curlex leased from the pool, goes back to the pool on destruction
+    /// (or is released, if the pool is already destroyed).
+    class Lease {
+        std::shared_ptr<State> state_;
+        std::unique_ptr<Curlex> cx_;
+    public:
+        Lease(std::shared_ptr<State> state, std::unique_ptr<Curlex> cx) noexcept
+                : state_{std::move(state)}, cx_{std::move(cx)} {}
+        Lease(Lease&& other) noexcept = default;
+        Lease& operator=(Lease&&) = delete;
+        ~Lease() {
+            if (cx_)
+                state_->give_back(std::move(cx_));
+        }
+        Curlex& operator*() const noexcept {
+            return *cx_;
+        }
+        Curlex* operator->() const noexcept {
+            return cx_.get();
+        }
+    };
+
+    /// \param capacity - max number of leased handles (0 - no limit),
+    /// \param max_idle - max number of idle connections kept by each handle (0 - curl's default),
+    /// \param max_idle_age - max seconds an idle connection is reused (0 - curl's default).
+    explicit CurlexPool(size_t capacity = 0, long max_idle = 0, long max_idle_age = 0);
+    ~CurlexPool();
+    CurlexPool(CurlexPool const&) = delete;
+    CurlexPool& operator=(CurlexPool const&) = delete;
+
+    /// Take a handle from the pool, waits if all handles are leased.
+    [[nodiscard]] Lease lease();
+
+    /// Metrics of requests executed by all handles of the pool.
+    [[nodiscard]] Metrics const& metrics() const noexcept {
+        return *metrics_;
+    }
+};
@@ -0,0 +1,92 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "reactor.h"
+#include <algorithm>
+#include <functional>
+
+Reactor::Reactor(size_t const threads, std::shared_ptr<Share> const& share, std::shared_ptr<Metrics> const& metrics) {
+    auto const n = std::max<size_t>(threads, 1);
+    engines_.reserve(n);
+    // The share holds only the DNS cache and TLS sessions (safe to share by
+    // threads), connections stay in the connection cache of each engine.
+    for (size_t i = 0; i < n; ++i)
+        engines_.push_back(std::make_unique<Engine>(share, metrics));
+}
+
+//-------------------------------------------------------------------
+/// Queue the request on the engine selected for its host.
+/// \param method - HTTP method to use,
+/// \param req - request to execute,
+/// \param callback - called on the engine's thread with the response,
+/// \param delay - time to wait before the start,
+/// \param cancel - optional flag cancelling the request.
+//-------------------------------------------------------------------
+void Reactor::submit(Method const method, Request req, Engine::Callback callback,
+                     std::chrono::milliseconds const delay, Transfer::Cancel cancel) noexcept {
+    auto& engine = select(req.host());
+    engine.submit(method, std::move(req), std::move(callback), delay, std::move(cancel));
+}
+
+//-------------------------------------------------------------------
+/// Number of requests which are submitted to all engines and aren't completed yet.
+//-------------------------------------------------------------------
+size_t Reactor::load() const noexcept {
+    size_t total{};
+    for (auto const& engine : engines_)
+        total += engine->load();
+    return total;
+}
+
+/********************************************************************
+*                                                                   *
+*                         P R I V A T E                             *
+*                                                                   *
+********************************************************************/
+
+/// The engine of the host, or the least loaded one if the host's engine is backed up.
+Engine& Reactor::select(std::string_view const host) const noexcept {
+    if (engines_.size() == 1)
+        return *engines_.front();
+
+    auto& home = *engines_[std::hash<std::string_view>{}(host) % engines_.size()];
+    auto const home_load = home.load();
+    if (home_load <= STEAL_MARGIN)
+        return home;
+
+    auto least = &home;
+    auto least_load = home_load;
+    for (auto const& engine : engines_)
+        if (auto const load = engine->load(); load < least_load) {
+            least = engine.get();
+            least_load = load;
+        }
+    return home_load > STEAL_MARGIN + 2 * least_load ? *least : home;
+}
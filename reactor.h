@@ -0,0 +1,70 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <string_view>
+#include "engine.h"
+
+/// Runs transfers on many engines (event-loop threads), each with its own
+/// multi handle and connection cache. Requests to one host go to the same
+/// engine (its connections to the host are there), unless that engine is
+/// backed up and another one is idle, which then takes the request.
+class Reactor {
+    // A request leaves its engine if the engine has more requests
+    // than STEAL_MARGIN plus twice the load of the least loaded one.
+    static constexpr size_t STEAL_MARGIN = 32;
+    std::vector<std::unique_ptr<Engine>> engines_{};
+public:
+    /// \param threads - number of engines (at least one),
+    /// \param share - DNS cache and TLS sessions shared by all engines (if any),
+    /// \param metrics - records requests of all engines (if any).
+    explicit Reactor(size_t threads = 1, std::shared_ptr<Share> const& share = {},
+                     std::shared_ptr<Metrics> const& metrics = {});
+    Reactor(Reactor const&) = delete;
+    Reactor& operator=(Reactor const&) = delete;
+
+    /// Queue the request on the engine selected for its host.
+    /// The callback is called on that engine's thread.
+    void submit(Method method, Request req, Engine::Callback callback,
+                std::chrono::milliseconds delay = {}, Transfer::Cancel cancel = {}) noexcept;
+
+    [[nodiscard]] size_t size() const noexcept {
+        return engines_.size();
+    }
+    /// Number of submitted requests which aren't completed yet
+    /// (delayed ones count from their start).
+    [[nodiscard]] size_t load() const noexcept;
+
+private:
+    [[nodiscard]] Engine& select(std::string_view host) const noexcept;
+};
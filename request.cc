@@ -29,40 +29,64 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include "request.h"
-#include <span>
+#include "shared.h"
+#include <array>
+#include <cstring>
 #include <utility>
-#include <fmt/core.h>
+#include "logger.h"
 
+// Characters which may appear in a query unencoded (RFC 3986 unreserved).
+static constexpr auto unreserved = [] {
+    std::array<bool, 256> table{};
+    for (int c = '0'; c <= '9'; ++c) table[c] = true;
+    for (int c = 'a'; c <= 'z'; ++c) table[c] = true;
+    for (int c = 'A'; c <= 'Z'; ++c) table[c] = true;
+    for (unsigned char c : {'-', '.', '_', '~'}) table[c] = true;
+    return table;
+}();
+
+//-------------------------------------------------------------------
+/// Build the URL in one pass: the exact size is computed first,
+/// then all components are written into the reserved buffer.
+/// Keys and values of params are percent-encoded (RFC 3986).
+//-------------------------------------------------------------------
 Request& Request::build() noexcept {
-    url_ = fmt::format("{}://{}/{}", scheme_, host_, endpoint_);
-    if (!params_.empty()) {
-        std::span span{params_};
-        auto [k, v] = span.front();
-        url_ += fmt::format("?{}={}", k, v);
-        span = span.subspan(1);
+    auto size = scheme_.size() + 3 + host_.size() + 1 + endpoint_.size();
+    for (auto const& [k, v] : params_)
+        size += 2 + encoded_size(k) + encoded_size(v);
 
-        while (!span.empty()) {
-            auto [k, v] = span.front();
-            url_ += fmt::format("&{}={}", k, v);
-            span = span.subspan(1);
-        }
+    url_.resize(size);
+    auto out = url_.data();
+    auto put = [&out](std::string_view text) {
+        std::memcpy(out, text.data(), text.size());
+        out += text.size();
+    };
+    put(scheme_);
+    put("://");
+    put(host_);
+    put("/");
+    put(endpoint_);
+
+    char separator = '?';
+    for (auto const& [k, v] : params_) {
+        *out++ = separator;
+        out = encode(k, out);
+        *out++ = '=';
+        out = encode(v, out);
+        separator = '&';
     }
     return *this;
 }
 
-Request& Request::add_param(std::string const& k, std::variant<std::string, int64_t, double_t> v) noexcept {
-    if (!k.empty()) {
-        if (!exists(params_, k)) params_.emplace_back(k, as_string(std::move(v)));
-        else fmt::print(stderr, "Repeated parameter key not accepted ({})", k);
-    }
+Request& Request::add_param(std::string const& k, std::variant<std::string, int64_t, double_t> v, Policy const policy) noexcept {
+    if (!k.empty())
+        add(params_, params_index_, k, as_string(std::move(v)), policy);
     return *this;
 }
 
-Request& Request::add_header(std::string const& k, std::variant<std::string, int64_t, double_t> v) noexcept {
-    if (!k.empty()) {
-        if (!exists(headers_, k)) headers_.emplace_back(k, as_string(std::move(v)));
-        else fmt::print(stderr, "Repeated header key not accepted ({})", k);
-    }
+Request& Request::add_header(std::string const& k, std::variant<std::string, int64_t, double_t> v, Policy const policy) noexcept {
+    if (!k.empty())
+        add(headers_, headers_index_, k, as_string(std::move(v)), policy);
     return *this;
 }
 
@@ -73,13 +97,31 @@ Request& Request::add_header(std::string const& k, std::variant<std::string, int
 ********************************************************************/
 
 
-bool Request::exists(KeyValueVec const& vec, std::string const& key) noexcept {
-    for (auto const& pair : vec) {
-        auto  [key_in_vec, _] = pair;
-        if (key_in_vec == key)
-            return true;
+/// Add the key-value pair to the vector according to the policy.
+/// \param vec - params or headers,
+/// \param index - positions of keys in the vector,
+/// \param k - key of the pair,
+/// \param value - value of the key,
+/// \param policy - what to do if the key is already present.
+void Request::add(KeyValueVec& vec, KeyIndex& index, std::string const& k, std::string value, Policy const policy) noexcept {
+    auto const position = index.find(vec, k);
+    if (!position) {
+        vec.emplace_back(k, std::move(value));
+        index.added(vec);
+        return;
+    }
+    switch (policy) {
+        case Policy::Reject:
+            logger::print("Repeated key not accepted ({})", k);
+            break;
+        case Policy::Replace:
+            vec[*position].second = std::move(value);
+            break;
+        case Policy::Append:
+            // The index keeps the first occurrence.
+            vec.emplace_back(k, std::move(value));
+            break;
     }
-    return {};
 }
 
 std::string Request::as_string(std::variant<std::string, int64_t, double_t> v) noexcept {
@@ -97,3 +139,30 @@ std::string Request::as_string(std::variant<std::string, int64_t, double_t> v) n
     }
     return value;
 }
+
+/// Size of the text after percent-encoding.
+size_t Request::encoded_size(std::string_view const text) noexcept {
+    auto size = text.size();
+    for (unsigned char const c : text)
+        if (!unreserved[c])
+            size += 2;
+    return size;
+}
+
+/// Write percent-encoded text.
+/// \param text - text to encode,
+/// \param out - where to write (there must be room for 'encoded_size(text)' chars),
+/// \return position after the written text.
+char* Request::encode(std::string_view const text, char* out) noexcept {
+    static constexpr char hex[] = "0123456789ABCDEF";
+    for (unsigned char const c : text) {
+        if (unreserved[c])
+            *out++ = static_cast<char>(c);
+        else {
+            *out++ = '%';
+            *out++ = hex[c >> 4];
+            *out++ = hex[c & 0xf];
+        }
+    }
+    return out;
+}
@@ -29,23 +29,58 @@
 
 /*------- include files:
 -------------------------------------------------------------------*/
+#include <cmath>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <utility>
 #include <variant>
+#include <memory>
+#include <optional>
+#include <glaze/glaze.hpp>
+#include "source.h"
+#include "policy.h"
+#include "logger.h"
+#include "key_index.h"
 
 
+/// HTTP version to use. Default is curl's choice
+/// (HTTP/2 over TLS if available, HTTP/1.1 otherwise).
+enum class HttpVersion {
+    Default,
+    Http1_1,
+    Http2PriorKnowledge,    // HTTP/2 without upgrade (h2c on plain connections)
+    Http2Tls,               // HTTP/2 over TLS, HTTP/1.1 on plain connections
+    Http3                   // if libcurl supports it, HTTP/2 over TLS otherwise
+};
+
 class Request {
-    using KeyValueVec = std::vector<std::pair<std::string, std::string>>;
+public:
+    /// What to do when a param or a header with the same key is added again.
+    enum class Policy { Reject, Replace, Append };
+private:
+    using KeyValueVec = KeyIndex::KeyValueVec;
     std::string scheme_{"https"};   // default schema
     std::string host_{};
     std::string endpoint_{};
     std::string data_{};
+    std::shared_ptr<Source> upload_{};
     KeyValueVec params_{};
+    KeyIndex params_index_{};
     std::string body_;
+    // The value given to 'json()' couldn't be serialized, the request fails.
+    bool invalid_json_{};
     KeyValueVec headers_{};
+    // Header names are case-insensitive.
+    KeyIndex headers_index_{true};
     bool verbose_{};
+    bool compression_{true};
+    std::optional<HttpVersion> http_version_{};
     std::string url_{};
+    std::chrono::milliseconds connect_timeout_{};
+    std::chrono::milliseconds timeout_{};
+    std::optional<RetryPolicy> retry_{};
+    std::optional<HedgePolicy> hedge_{};
 public:
     Request() = default;
     Request& scheme(std::string const& text) noexcept {
@@ -56,6 +91,9 @@ public:
         host_ = text;
         return *this;
     }
+    [[nodiscard]] std::string const& host() const noexcept {
+        return host_;
+    }
     Request& endpoint(std::string const& text) noexcept {
         endpoint_ = text;
         return *this;
@@ -67,27 +105,59 @@ public:
     [[nodiscard]] std::string const& data() const noexcept {
         return data_;
     }
+    /// Stream the body of the request from the source (file, generator).
+    /// The source is shared by copies of the request and can be read once.
+    Request& upload(Source source) noexcept {
+        upload_ = std::make_shared<Source>(std::move(source));
+        return *this;
+    }
+    [[nodiscard]] Source const* upload() const noexcept {
+        return upload_.get();
+    }
 
     /// Add a param.
     /// When all params are added call 'build()'.
     /// After that, the whole URL can you obtain via 'product()'.
-    Request& add_param(std::string const& k, std::variant<std::string, int64_t, double_t> v) noexcept;
+    /// By default a repeated key is rejected.
+    Request& add_param(std::string const& k, std::variant<std::string, int64_t, double_t> v, Policy policy = Policy::Reject) noexcept;
 
     /// Remove all params and product.
     Request& reset_params() noexcept {
         params_ = {};
+        params_index_.clear();
         url_ = {};
         return *this;
     }
 
     Request& body(std::string const& text) noexcept {
         body_ = text;
+        invalid_json_ = false;
         return *this;
     }
     [[nodiscard]] std::string const& body() const noexcept {
         return body_;
     }
-    /// Build the URL using all components and params.
+    /// Serialize the value as JSON directly into the body buffer
+    /// (its capacity is reused) and set the content type.
+    /// If the value can't be serialized, the request fails when it's performed
+    /// (CURLE_BAD_FUNCTION_ARGUMENT, stage "JSON").
+    template<typename T>
+    Request& json(T const& value) noexcept {
+        body_.clear();
+        invalid_json_ = false;
+        if (auto ec = glz::write_json(value, body_)) {
+            logger::print("Request.JSON: {}", glz::format_error(ec, body_));
+            body_.clear();
+            invalid_json_ = true;
+            return *this;
+        }
+        return add_header("Content-Type", std::string("application/json"), Policy::Replace);
+    }
+    [[nodiscard]] bool invalid_json() const noexcept {
+        return invalid_json_;
+    }
+    /// Build the URL using all components and params
+    /// (keys and values of params are percent-encoded).
     Request& build() noexcept;
 
     /// Return the URL.
@@ -95,7 +165,8 @@ public:
         return url_;
     }
 
-    Request& add_header(std::string const& k, std::variant<std::string, int64_t, double_t> v) noexcept;
+    /// Header names are case-insensitive, by default a repeated one is rejected.
+    Request& add_header(std::string const& k, std::variant<std::string, int64_t, double_t> v, Policy policy = Policy::Reject) noexcept;
     KeyValueVec const& headers()  const noexcept {
         return headers_;
     }
@@ -106,7 +177,57 @@ public:
     [[nodiscard]] bool is_verbose() const noexcept {
         return verbose_;
     }
+
+    /// Ask for a compressed response (all encodings libcurl can decode);
+    /// the body is decoded on the fly, also when it goes to a sink.
+    Request& compression(bool const on) noexcept {
+        compression_ = on;
+        return *this;
+    }
+    [[nodiscard]] bool compression() const noexcept {
+        return compression_;
+    }
+    /// HTTP version of the request (overrides the client's preference).
+    Request& http_version(HttpVersion const version) noexcept {
+        http_version_ = version;
+        return *this;
+    }
+    [[nodiscard]] std::optional<HttpVersion> http_version() const noexcept {
+        return http_version_;
+    }
+    /// Max time of connecting (0 - curl's default).
+    Request& connect_timeout(std::chrono::milliseconds const ms) noexcept {
+        connect_timeout_ = ms;
+        return *this;
+    }
+    [[nodiscard]] std::chrono::milliseconds connect_timeout() const noexcept {
+        return connect_timeout_;
+    }
+    /// Max time of the whole transfer, of every attempt (0 - no limit).
+    Request& timeout(std::chrono::milliseconds const ms) noexcept {
+        timeout_ = ms;
+        return *this;
+    }
+    [[nodiscard]] std::chrono::milliseconds timeout() const noexcept {
+        return timeout_;
+    }
+    Request& retry(RetryPolicy const& policy) noexcept {
+        retry_ = policy;
+        return *this;
+    }
+    [[nodiscard]] std::optional<RetryPolicy> const& retry() const noexcept {
+        return retry_;
+    }
+    Request& hedge(HedgePolicy const& policy) noexcept {
+        hedge_ = policy;
+        return *this;
+    }
+    [[nodiscard]] std::optional<HedgePolicy> const& hedge() const noexcept {
+        return hedge_;
+    }
 private:
-    static bool exists(KeyValueVec const& vec, std::string const& key) noexcept;
+    static void add(KeyValueVec& vec, KeyIndex& index, std::string const& k, std::string value, Policy policy) noexcept;
     static std::string as_string(std::variant<std::string, int64_t, double_t> v) noexcept;
+    static size_t encoded_size(std::string_view text) noexcept;
+    static char* encode(std::string_view text, char* out) noexcept;
 };
\ No newline at end of file
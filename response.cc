@@ -0,0 +1,131 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "response.h"
+#include "shared.h"
+#include <algorithm>
+
+//-------------------------------------------------------------------
+/// Find the header by its name.
+/// \param name - name of the header (case-insensitive),
+/// \return the value of the header if present.
+//-------------------------------------------------------------------
+std::optional<std::string_view> Response::header(std::string_view const name) const noexcept {
+    auto const& fields = this->fields();
+    auto const it = std::lower_bound(fields.begin(), fields.end(), name,
+                                     [this](Field const& field, std::string_view key) {
+                                         return shared::iless(name_of(field), key);
+                                     });
+    if (it != fields.end() && shared::iequals(name_of(*it), name))
+        return value_of(*it);
+    return {};
+}
+
+std::vector<std::pair<std::string_view, std::string_view>> Response::header_fields() const noexcept {
+    std::vector<std::pair<std::string_view, std::string_view>> result;
+    result.reserve(fields().size());
+    for (auto const& field : fields())
+        result.emplace_back(name_of(field), value_of(field));
+    return result;
+}
+
+std::vector<std::string> const& Response::headers() const noexcept {
+    auto const& fields = this->fields();
+    if (lines_.empty() && !fields.empty()) {
+        lines_.reserve(fields.size());
+        for (auto const& field : fields) {
+            auto& line = lines_.emplace_back(name_of(field));
+            line.append(": ").append(value_of(field));
+        }
+        std::sort(lines_.begin(), lines_.end());
+    }
+    return lines_;
+}
+
+/********************************************************************
+*                                                                   *
+*                         P R I V A T E                             *
+*                                                                   *
+********************************************************************/
+
+/// Find positions of all fields in the raw headers block.
+/// Only the last block counts (earlier ones come from redirects or '100 Continue').
+void Response::parse() const noexcept {
+    if (parsed_ || shared_)
+        return;
+    parsed_ = true;
+
+    std::string_view const raw{headers_raw_};
+    size_t pos = 0;
+    while (pos < raw.size()) {
+        auto end = shared::find(raw, '\n', pos);
+        if (end == std::string_view::npos)
+            end = raw.size();
+        auto const line = raw.substr(pos, end - pos);
+        pos = end + 1;
+
+        if (line.starts_with("HTTP/")) {
+            fields_.clear();
+            continue;
+        }
+        auto const colon = line.find(':');
+        if (colon == std::string_view::npos)
+            continue;
+        auto const name = shared::trim_view(line.substr(0, colon));
+        auto const value = shared::trim_view(line.substr(colon + 1));
+        if (name.empty())
+            continue;
+        fields_.push_back(Field{
+                static_cast<uint32_t>(name.data() - raw.data()), static_cast<uint32_t>(name.size()),
+                static_cast<uint32_t>(value.data() - raw.data()), static_cast<uint32_t>(value.size())});
+    }
+    std::stable_sort(fields_.begin(), fields_.end(),
+                     [this](Field const& f0, Field const& f1) {
+                         return shared::iless(name_of(f0), name_of(f1));
+                     });
+}
+
+/// Take own copies of the shared body and headers (before they are changed),
+/// the last owner takes them without copying.
+void Response::unshare() {
+    if (!shared_)
+        return;
+    if (shared_.use_count() == 1) {
+        body_ = std::move(shared_->body);
+        headers_raw_ = std::move(shared_->headers_raw);
+        fields_ = std::move(shared_->fields);
+    } else {
+        body_ = shared_->body;
+        headers_raw_ = shared_->headers_raw;
+        fields_ = shared_->fields;
+    }
+    parsed_ = true;
+    shared_.reset();
+}
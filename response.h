@@ -32,40 +32,149 @@
 #include <string>
 #include <string_view>
 #include <vector>
-#include <algorithm>
-#include "shared.h"
+#include <utility>
+#include <optional>
+#include <cstdint>
+#include <memory>
+#include <glaze/glaze.hpp>
+#include "result.h"
+#include "logger.h"
+
+/// Statistics of the transfer as reported by curl.
+/// Times are in microseconds, measured from the start of the transfer.
+struct Stats {
+    int64_t name_lookup_us{};   // DNS resolved
+    int64_t connect_us{};       // TCP connected
+    int64_t tls_us{};           // TLS handshake done
+    int64_t pretransfer_us{};   // about to send the request
+    int64_t first_byte_us{};    // first byte of the response received
+    int64_t total_us{};
+    int64_t redirect_us{};      // spent in redirects before the final transfer
+    int64_t uploaded{};         // bytes
+    int64_t downloaded{};       // bytes of the body as received (compressed)
+    int64_t decoded{};          // bytes of the body after content decoding
+    long redirects{};
+    int http_version{};         // of the response: 10, 11, 20, 30
+    bool reused{};              // the connection was reused (no new connect)
+};
 
 class Response {
+    // Position of a header field in the raw headers block.
+    struct Field {
+        uint32_t name_pos;
+        uint32_t name_len;
+        uint32_t value_pos;
+        uint32_t value_len;
+    };
+    // Body and headers shared by copies of the response (e.g. cached ones), immutable.
+    struct Shared {
+        std::string body;
+        std::string headers_raw;
+        std::vector<Field> fields;
+    };
     long code_;
     std::string body_;
-    std::vector<std::string> headers_;
+    // Not modified while shared, the last owner may move out of it.
+    std::shared_ptr<Shared> shared_{};
+    std::string headers_raw_{};
+    Stats stats_{};
+    // Parsed on the first access to headers (not synchronized).
+    mutable bool parsed_{};
+    mutable std::vector<Field> fields_{};
+    mutable std::vector<std::string> lines_{};
 public:
     explicit Response(long const code) : code_{code} {
     }
-    Response& body(std::string&& text) noexcept {
+    Response& body(std::string&& text) {
+        unshare();
         body_ = std::move(text);
         return *this;
     }
-    Response& headers(std::string&& text) noexcept {
-        auto items = shared::split(text, '\n');
-        for (auto&& str : items) {
-            if (str.contains(':'))
-                headers_.push_back(str);
+    /// Make the body and the headers immutable and shared,
+    /// copies of the response only bump the reference count.
+    Response& share() {
+        if (!shared_) {
+            parse();
+            shared_ = std::make_shared<Shared>(Shared{std::move(body_), std::move(headers_raw_), std::move(fields_)});
+            body_ = {};
+            headers_raw_ = {};
+            fields_ = {};
+            lines_ = {};
         }
-        std::sort(headers_.begin(), headers_.end(),
-                  [] (std::string const& s0, std::string const& s1)  {
-                      return std::lexicographical_compare(s0.begin(), s0.end(), s1.begin(), s1.end());
-                  });
+        return *this;
+    }
+    /// Set the raw headers block as received from the server.
+    /// It's parsed only when any header is requested.
+    Response& headers(std::string&& text) {
+        unshare();
+        headers_raw_ = std::move(text);
+        parsed_ = false;
+        fields_.clear();
+        lines_.clear();
+        return *this;
+    }
+
+    Response& stats(Stats const& stats) noexcept {
+        stats_ = stats;
         return *this;
     }
 
     [[nodiscard]] long code() const noexcept {
         return code_;
     }
-    [[nodiscard]] std::string const& body() const noexcept {
-        return body_;
+    [[nodiscard]] std::string const& body() const& noexcept {
+        return shared_ ? shared_->body : body_;
+    }
+    /// The body is moved out. A shared one only by its last owner,
+    /// otherwise it's copied (e.g. the cache still holds it).
+    [[nodiscard]] std::string body() && {
+        if (!shared_)
+            return std::move(body_);
+        if (shared_.use_count() == 1)
+            return std::move(shared_->body);
+        return shared_->body;
+    }
+    [[nodiscard]] Stats const& stats() const noexcept {
+        return stats_;
+    }
+
+    /// Parse the body as JSON, directly from the receive buffer.
+    template<typename T>
+    [[nodiscard]] Result<T> json() const noexcept {
+        T value{};
+        if (auto ec = glz::read_json(value, body())) {
+            logger::print("Response.JSON: {}", glz::format_error(ec, body()));
+            return Error{CURLE_WEIRD_SERVER_REPLY, "JSON"};
+        }
+        return value;
+    }
+
+    /// Value of the header (case-insensitive name), e.g. header("content-type").
+    /// If the header is repeated, the first value is returned.
+    [[nodiscard]] std::optional<std::string_view> header(std::string_view name) const noexcept;
+    /// All header fields of the final response as name-value views,
+    /// sorted by name (case-insensitive). Views are valid as long as the response.
+    [[nodiscard]] std::vector<std::pair<std::string_view, std::string_view>> header_fields() const noexcept;
+    /// Header lines ('Name: value') of the final response, sorted.
+    [[nodiscard]] std::vector<std::string> const& headers() const noexcept;
+    /// The raw headers block as received from the server.
+    [[nodiscard]] std::string const& headers_raw() const noexcept {
+        return shared_ ? shared_->headers_raw : headers_raw_;
+    }
+
+private:
+    void parse() const noexcept;
+    void unshare();
+    [[nodiscard]] std::vector<Field> const& fields() const noexcept {
+        if (shared_)
+            return shared_->fields;
+        parse();
+        return fields_;
+    }
+    [[nodiscard]] std::string_view name_of(Field const& field) const noexcept {
+        return {headers_raw().data() + field.name_pos, field.name_len};
     }
-    [[nodiscard]] std::vector<std::string> const& headers() const noexcept {
-        return headers_;
+    [[nodiscard]] std::string_view value_of(Field const& field) const noexcept {
+        return {headers_raw().data() + field.value_pos, field.value_len};
     }
-};
\ No newline at end of file
+};
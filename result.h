@@ -0,0 +1,136 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <curl/curl.h>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <variant>
+#include <stdexcept>
+#include <fmt/core.h>
+
+/// Why a request failed.
+struct Error {
+    using Clock = std::chrono::steady_clock;
+
+    CURLcode code{CURLE_OK};
+    // Step which failed, e.g. "URL", "PERFORM", "RESPONSE_CODE".
+    char const* stage{""};
+    // Time from the start of the request to the failure.
+    int64_t elapsed_us{};
+
+    /// Set the elapsed time since the start of the request.
+    Error& since(Clock::time_point const start) noexcept {
+        elapsed_us = std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+        return *this;
+    }
+    [[nodiscard]] char const* reason() const noexcept {
+        return curl_easy_strerror(code);
+    }
+    [[nodiscard]] std::string message() const {
+        return fmt::format("{}: {} ({}us)", stage, reason(), elapsed_us);
+    }
+};
+
+/// Thrown by 'Result::value()' if there is no value.
+class BadResultAccess : public std::runtime_error {
+    Error error_;
+public:
+    explicit BadResultAccess(Error error)
+            : std::runtime_error(error.message()), error_{error} {}
+    [[nodiscard]] Error const& error() const noexcept {
+        return error_;
+    }
+};
+
+/// The value or the error (like 'std::expected', which is not in C++20).
+template<typename T>
+class Result {
+    std::variant<T, Error> data_;
+public:
+    Result(T value) noexcept : data_{std::in_place_index<0>, std::move(value)} {}
+    Result(Error error) noexcept : data_{std::in_place_index<1>, error} {}
+
+    [[nodiscard]] bool has_value() const noexcept {
+        return data_.index() == 0;
+    }
+    explicit operator bool() const noexcept {
+        return has_value();
+    }
+
+    // Access without checking (like std::optional).
+    T& operator*() & noexcept {
+        return *std::get_if<0>(&data_);
+    }
+    T const& operator*() const& noexcept {
+        return *std::get_if<0>(&data_);
+    }
+    T&& operator*() && noexcept {
+        return std::move(*std::get_if<0>(&data_));
+    }
+    T* operator->() noexcept {
+        return std::get_if<0>(&data_);
+    }
+    T const* operator->() const noexcept {
+        return std::get_if<0>(&data_);
+    }
+
+    T& value() & {
+        check();
+        return **this;
+    }
+    T const& value() const& {
+        check();
+        return **this;
+    }
+    T&& value() && {
+        check();
+        return std::move(**this);
+    }
+    template<typename U>
+    [[nodiscard]] T value_or(U&& other) const& {
+        return has_value() ? **this : static_cast<T>(std::forward<U>(other));
+    }
+
+    /// The error, valid only if there is no value.
+    [[nodiscard]] Error const& error() const noexcept {
+        return *std::get_if<1>(&data_);
+    }
+    [[nodiscard]] Error& error() noexcept {
+        return *std::get_if<1>(&data_);
+    }
+
+private:
+    void check() const {
+        if (!has_value())
+            throw BadResultAccess(error());
+    }
+};
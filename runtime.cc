@@ -0,0 +1,56 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "runtime.h"
+#include "logger.h"
+#include <curl/curl.h>
+
+namespace runtime {
+    namespace {
+        // Objects initialized before it are released after it,
+        // so static clients (and their shares) are cleaned up before libcurl.
+        struct Global {
+            CURLcode const code;
+            Global() noexcept : code{curl_global_init(CURL_GLOBAL_DEFAULT)} {
+                if (code)
+                    logger::print("Runtime.GLOBAL_INIT: {}", curl_easy_strerror(code));
+            }
+            ~Global() {
+                if (code == CURLE_OK)
+                    curl_global_cleanup();
+            }
+        };
+    }
+
+    bool ensure() noexcept {
+        static Global const global{};
+        return global.code == CURLE_OK;
+    }
+}
@@ -0,0 +1,89 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "share.h"
+#include "logger.h"
+#include "runtime.h"
+
+Share::Share(long const max_idle, long const max_idle_age)
+        : handle_{(runtime::ensure(), curl_share_init())}, max_idle_{max_idle}, max_idle_age_{max_idle_age}
+{
+    curl_share_setopt(handle_, CURLSHOPT_LOCKFUNC, lock);
+    curl_share_setopt(handle_, CURLSHOPT_UNLOCKFUNC, unlock);
+    curl_share_setopt(handle_, CURLSHOPT_USERDATA, this);
+
+    // Not the connection cache: libcurl doesn't support sharing connections
+    // by handles used at the same time by different threads.
+    for (auto const data : {CURL_LOCK_DATA_DNS, CURL_LOCK_DATA_SSL_SESSION})
+        if (auto err = curl_share_setopt(handle_, CURLSHOPT_SHARE, data); err)
+            logger::print("Share.SHARE: {}", curl_share_strerror(err));
+}
+
+Share::~Share() {
+    if (auto err = curl_share_cleanup(handle_); err)
+        logger::print("Share.CLEANUP: {}", curl_share_strerror(err));
+}
+
+//-------------------------------------------------------------------
+/// Attach the handle to the shared caches and set limits of its connection cache.
+/// \param handle - CURL handle to configure,
+/// \return CURLE_OK if all options were accepted, the error otherwise.
+//-------------------------------------------------------------------
+CURLcode Share::apply(CURL* const handle) const noexcept {
+    if (auto err = curl_easy_setopt(handle, CURLOPT_SHARE, handle_); err) {
+        logger::print("Share.SHARE: {}", curl_easy_strerror(err));
+        return err;
+    }
+    if (max_idle_)
+        if (auto err = curl_easy_setopt(handle, CURLOPT_MAXCONNECTS, max_idle_); err) {
+            logger::print("Share.MAXCONNECTS: {}", curl_easy_strerror(err));
+            return err;
+        }
+    if (max_idle_age_)
+        if (auto err = curl_easy_setopt(handle, CURLOPT_MAXAGE_CONN, max_idle_age_); err) {
+            logger::print("Share.MAXAGE_CONN: {}", curl_easy_strerror(err));
+            return err;
+        }
+    return CURLE_OK;
+}
+
+/********************************************************************
+*                                                                   *
+*                         P R I V A T E                             *
+*                                                                   *
+********************************************************************/
+
+void Share::lock(CURL*, curl_lock_data const data, curl_lock_access, void* const self) noexcept {
+    reinterpret_cast<Share*>(self)->locks_[data].lock();
+}
+
+void Share::unlock(CURL*, curl_lock_data const data, void* const self) noexcept {
+    reinterpret_cast<Share*>(self)->locks_[data].unlock();
+}
@@ -0,0 +1,59 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <curl/curl.h>
+#include <array>
+#include <mutex>
+
+/// DNS cache and TLS session cache shared by many CURL handles (possibly
+/// used by many threads). Connections stay in the cache of each handle (or
+/// multi handle), the share only sets limits of those caches.
+class Share {
+    CURLSH* handle_;
+    long max_idle_;
+    long max_idle_age_;
+    std::array<std::mutex, CURL_LOCK_DATA_LAST> locks_{};
+public:
+    /// \param max_idle - max number of idle connections kept in a handle's cache (0 - curl's default),
+    /// \param max_idle_age - max seconds an idle connection is reused (0 - curl's default).
+    explicit Share(long max_idle = 0, long max_idle_age = 0);
+    ~Share();
+    Share(Share const&) = delete;
+    Share& operator=(Share const&) = delete;
+
+    /// Attach the handle to the shared caches.
+    /// Must be called again after every reset of the handle.
+    [[nodiscard]] CURLcode apply(CURL* handle) const noexcept;
+
+private:
+    static void lock(CURL* handle, curl_lock_data data, curl_lock_access access, void* self) noexcept;
+    static void unlock(CURL* handle, curl_lock_data data, void* self) noexcept;
+};
@@ -30,14 +30,20 @@
 /*------- include files:
 -------------------------------------------------------------------*/
 #include <string>
+#include <string_view>
 #include <vector>
-#include <numeric>
-#include <sstream>
-#include <fmt/core.h>
+#include <cctype>
+#include <cstring>
+#include <algorithm>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 namespace shared {
     static inline bool is_not_space(char c) noexcept {
-        return not std::isspace(c);
+        return not std::isspace(static_cast<unsigned char>(c));
     }
 
     static inline std::string trim_left(std::string s) noexcept {
@@ -54,45 +60,135 @@ namespace shared {
         return trim_left(trim_right(std::move(s)));
     }
 
-    static inline std::vector<std::string> split(std::string const &text, char const delimiter) noexcept {
-        auto const n = std::accumulate(
-                text.cbegin(),
-                text.cend(),
-                ssize_t {0},
-                [delimiter](ssize_t const count, char const c) {
-                    return (c == delimiter) ? count + 1 : count;
-                }
-        );
+    static inline std::string_view trim_view(std::string_view s) noexcept {
+        while (!s.empty() && !is_not_space(s.front()))
+            s.remove_prefix(1);
+        while (!s.empty() && !is_not_space(s.back()))
+            s.remove_suffix(1);
+        return s;
+    }
 
-        std::vector<std::string> tokens{};
-        tokens.reserve(n + 1);
+    /// Position of the first 'c' in the text starting from 'pos' (npos if not found).
+    /// Scans 32 (AVX2) or 16 (SSE2) bytes at once.
+    static inline size_t find(std::string_view const text, char const c, size_t pos = 0) noexcept {
+        auto const data = text.data();
+        auto const size = text.size();
+#if defined(__AVX2__)
+        auto const needle = _mm256_set1_epi8(c);
+        for (; pos + 32 <= size; pos += 32) {
+            auto const chunk = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(data + pos));
+            if (auto const mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle))); mask)
+                return pos + __builtin_ctz(mask);
+        }
+#elif defined(__SSE2__)
+        auto const needle = _mm_set1_epi8(c);
+        for (; pos + 16 <= size; pos += 16) {
+            auto const chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(data + pos));
+            if (auto const mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle))); mask)
+                return pos + __builtin_ctz(mask);
+        }
+#endif
+        if (pos >= size)
+            return std::string_view::npos;
+        auto const found = static_cast<char const*>(std::memchr(data + pos, c, size - pos));
+        return found ? static_cast<size_t>(found - data) : std::string_view::npos;
+    }
 
-        std::string token;
-        std::istringstream stream(text);
-        while (std::getline(stream, token, delimiter))
-            if (auto str = trim(token); !str.empty())
-                tokens.push_back(str);
+    /// Call 'fn' for every trimmed, non-empty token of the text. Doesn't allocate.
+    template<typename F>
+    static inline void for_each_token(std::string_view const text, char const delimiter, F&& fn) noexcept {
+        size_t pos = 0;
+        while (pos <= text.size()) {
+            auto end = find(text, delimiter, pos);
+            if (end == std::string_view::npos)
+                end = text.size();
+            if (auto const token = trim_view(text.substr(pos, end - pos)); !token.empty())
+                fn(token);
+            pos = end + 1;
+        }
+    }
+
+    /// Split the text into trimmed, non-empty views of it.
+    /// The vector is reused, so its capacity is kept between calls.
+    static inline void split_view(std::string_view const text, char const delimiter, std::vector<std::string_view>& tokens) noexcept {
+        tokens.clear();
+        for_each_token(text, delimiter, [&tokens](std::string_view token) {
+            tokens.push_back(token);
+        });
+    }
+
+    static inline std::vector<std::string> split(std::string const &text, char const delimiter) noexcept {
+        std::vector<std::string> tokens{};
+        for_each_token(text, delimiter, [&tokens](std::string_view token) {
+            tokens.emplace_back(token);
+        });
         return tokens;
     }
 
     static inline std::string join(std::vector<std::string> const& data, char delimiter = ',') noexcept {
-        return std::accumulate(
-                std::next(data.begin()),
-                data.end(),
-                data[0],
-                [delimiter](std::string a, std::string b) {
-                    return fmt::format("{}{}{}", std::move(a), delimiter, std::move(b));
-                }
-        );
+        if (data.empty())
+            return {};
+        size_t size = data.size() - 1;
+        for (auto const& str : data)
+            size += str.size();
+
+        std::string text;
+        text.reserve(size);
+        text.append(data[0]);
+        for (size_t i = 1; i < data.size(); ++i)
+            text.append(1, delimiter).append(data[i]);
+        return text;
+    }
+
+    static inline char ascii_lower(char const c) noexcept {
+        return (c >= 'A' && c <= 'Z') ? static_cast<char>(c + ('a' - 'A')) : c;
+    }
+
+    /// ASCII case folding in place (other bytes are not changed).
+    /// Converts 16 bytes at once with SSE2.
+    static inline void to_lower_in_place(char* const data, size_t const size) noexcept {
+        size_t i = 0;
+#if defined(__SSE2__)
+        auto const before_a = _mm_set1_epi8('A' - 1);
+        auto const after_z = _mm_set1_epi8('Z' + 1);
+        auto const bit = _mm_set1_epi8('a' - 'A');
+        for (; i + 16 <= size; i += 16) {
+            auto const p = reinterpret_cast<__m128i*>(data + i);
+            auto const chunk = _mm_loadu_si128(p);
+            // Signed compare, bytes >= 0x80 are negative and never match.
+            auto const upper = _mm_and_si128(_mm_cmpgt_epi8(chunk, before_a), _mm_cmplt_epi8(chunk, after_z));
+            _mm_storeu_si128(p, _mm_or_si128(chunk, _mm_and_si128(upper, bit)));
+        }
+#endif
+        for (; i < size; ++i)
+            data[i] = ascii_lower(data[i]);
+    }
+
+    static inline void to_lower_in_place(std::string& text) noexcept {
+        to_lower_in_place(text.data(), text.size());
     }
 
     static inline std::string to_lower(std::string_view in) noexcept {
-        std::string out;
-        out.reserve(in.size());
-        std::ranges::transform(in.begin(), in.end(), out.begin(),
-                               [](auto c) {
-                                   return static_cast<char>(std::tolower(c));
-                               });
+        std::string out{in};
+        to_lower_in_place(out);
         return out;
     }
+
+    /// Case-insensitive (ASCII) equality, e.g. for HTTP header names.
+    static inline bool iequals(std::string_view const a, std::string_view const b) noexcept {
+        if (a.size() != b.size())
+            return false;
+        for (size_t i = 0; i < a.size(); ++i)
+            if (ascii_lower(a[i]) != ascii_lower(b[i]))
+                return false;
+        return true;
+    }
+
+    /// Case-insensitive (ASCII) ordering, e.g. for HTTP header names.
+    static inline bool iless(std::string_view const a, std::string_view const b) noexcept {
+        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(),
+                                            [](char const c0, char const c1) {
+                                                return ascii_lower(c0) < ascii_lower(c1);
+                                            });
+    }
 }
@@ -0,0 +1,57 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <span>
+#include <cerrno>
+#include <functional>
+#include <unistd.h>
+
+/// Receives the body of a response chunk by chunk, as it arrives.
+/// The chunk is valid only during the call (no copy is made).
+/// Returning false aborts the transfer.
+using Sink = std::function<bool(std::span<char const>)>;
+
+namespace sink {
+    /// Sink writing all chunks to the file descriptor.
+    static inline Sink to_fd(int const fd) noexcept {
+        return [fd](std::span<char const> chunk) {
+            while (!chunk.empty()) {
+                auto const n = ::write(fd, chunk.data(), chunk.size());
+                if (n < 0) {
+                    if (errno == EINTR) continue;
+                    return false;
+                }
+                chunk = chunk.subspan(n);
+            }
+            return true;
+        };
+    }
+}
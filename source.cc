@@ -0,0 +1,100 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "source.h"
+#include <cerrno>
+#include <cstring>
+#include <memory>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "logger.h"
+
+//-------------------------------------------------------------------
+/// Create a source reading the file.
+/// \param path - path to the file,
+/// \param map - if true a regular file is memory mapped, otherwise read in chunks,
+/// \return the source, or nothing if the file can't be used.
+//-------------------------------------------------------------------
+std::optional<Source> Source::file(std::string const& path, bool const map) noexcept {
+    auto const fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        logger::print("Source.OPEN ({}): {}", path, std::strerror(errno));
+        return {};
+    }
+    struct stat st{};
+    if (::fstat(fd, &st) < 0) {
+        logger::print("Source.STAT ({}): {}", path, std::strerror(errno));
+        ::close(fd);
+        return {};
+    }
+    // Pipes, FIFOs and files like /proc/* (regular ones, but of size 0) report
+    // no size, they're read to the end with chunked transfer.
+    std::optional<size_t> size{};
+    if (S_ISREG(st.st_mode) && st.st_size > 0)
+        size = static_cast<size_t>(st.st_size);
+
+    if (map && size) {
+        auto const length = *size;
+        auto const ptr = ::mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (ptr == MAP_FAILED) {
+            logger::print("Source.MMAP ({}): {}", path, std::strerror(errno));
+            return {};
+        }
+        ::madvise(ptr, length, MADV_SEQUENTIAL);
+        // Unmapped when the last copy of the source is gone.
+        std::shared_ptr<char const> mapping(static_cast<char const*>(ptr), [length](char const* p) {
+            ::munmap(const_cast<char*>(p), length);
+        });
+        return Source([mapping, length, pos = size_t{}](std::span<char> buffer) mutable {
+            auto const n = std::min(buffer.size(), length - pos);
+            std::memcpy(buffer.data(), mapping.get() + pos, n);
+            pos += n;
+            return n;
+        }, size);
+    }
+
+    // Closed when the last copy of the source is gone.
+    std::shared_ptr<int> file(new int{fd}, [](int const* p) {
+        ::close(*p);
+        delete p;
+    });
+    return Source([file](std::span<char> buffer) {
+        while (true) {
+            auto const n = ::read(*file, buffer.data(), buffer.size());
+            if (n >= 0)
+                return static_cast<size_t>(n);
+            if (errno != EINTR)
+                return abort;
+        }
+    }, size);
+}
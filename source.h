@@ -0,0 +1,71 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <curl/curl.h>
+#include <span>
+#include <string>
+#include <optional>
+#include <functional>
+
+/// Produces the body of a request chunk by chunk, so the whole
+/// body never has to be in memory. Used for streaming uploads.
+class Source {
+public:
+    /// Fills the buffer and returns the number of written bytes (0 - end of data),
+    /// or 'Source::abort' to abort the transfer.
+    using Generator = std::function<size_t(std::span<char>)>;
+    static constexpr size_t abort = CURL_READFUNC_ABORT;
+private:
+    Generator generator_;
+    std::optional<size_t> size_;
+public:
+    /// \param generator - producer of the data,
+    /// \param size - total size of the data if known (otherwise chunked transfer is used).
+    explicit Source(Generator generator, std::optional<size_t> size = {}) noexcept
+            : generator_{std::move(generator)}, size_{size} {}
+
+    /// Source reading the file in chunks, or from its memory mapping. Only non-empty
+    /// regular files have a known size (and are mapped), others (pipes, /proc/*) are chunked.
+    /// \return the source, or nothing if the file can't be opened/mapped.
+    [[nodiscard]] static std::optional<Source> file(std::string const& path, bool map = false) noexcept;
+
+    [[nodiscard]] std::optional<size_t> size() const noexcept {
+        return size_;
+    }
+    size_t read(std::span<char> buffer) const {
+        return generator_(buffer);
+    }
+
+    /// Curl's read function, 'src' points to the source.
+    static size_t reader(char* const dst, size_t const one_item_size, size_t const items_count, void* const src) noexcept {
+        return reinterpret_cast<Source const*>(src)->read({dst, one_item_size * items_count});
+    }
+};
@@ -0,0 +1,175 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <future>
+#include <utility>
+#include <variant>
+#include <type_traits>
+
+/// Outcome of a task: the value (co_return) or the exception.
+template<typename T>
+struct TaskResult {
+    std::variant<std::monostate, T, std::exception_ptr> result{};
+
+    void return_value(T value) noexcept(std::is_nothrow_move_constructible_v<T>) {
+        result.template emplace<1>(std::move(value));
+    }
+    void unhandled_exception() noexcept {
+        result.template emplace<2>(std::current_exception());
+    }
+    [[nodiscard]] T take() {
+        if (result.index() == 2)
+            std::rethrow_exception(std::get<2>(result));
+        return std::move(std::get<1>(result));
+    }
+};
+
+template<>
+struct TaskResult<void> {
+    std::exception_ptr exception{};
+
+    void return_void() const noexcept {}
+    void unhandled_exception() noexcept {
+        exception = std::current_exception();
+    }
+    void take() const {
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+};
+
+/// Lazy coroutine returning T: it starts when it's awaited ('co_await task'),
+/// and the awaiting coroutine continues where the task finished.
+/// Outside coroutines the task is started with 'start' or 'get'.
+template<typename T = void>
+class Task {
+public:
+    struct promise_type : TaskResult<T> {
+        std::coroutine_handle<> continuation{};
+
+        Task get_return_object() noexcept {
+            return Task{std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        auto final_suspend() const noexcept { return Final{}; }
+    };
+    using Handle = std::coroutine_handle<promise_type>;
+private:
+    // Resumes the awaiting coroutine (if any) when the task is finished.
+    struct Final {
+        bool await_ready() const noexcept { return false; }
+        std::coroutine_handle<> await_suspend(Handle const handle) const noexcept {
+            if (auto const next = handle.promise().continuation)
+                return next;
+            return std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+    };
+    // Coroutine nobody awaits, it destroys itself at the end.
+    struct Detached {
+        struct promise_type {
+            Detached get_return_object() const noexcept { return {}; }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+    };
+    Handle handle_;
+    explicit Task(Handle const handle) noexcept : handle_{handle} {}
+public:
+    Task(Task&& other) noexcept : handle_{std::exchange(other.handle_, {})} {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_)
+                handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+    Task(Task const&) = delete;
+    Task& operator=(Task const&) = delete;
+    ~Task() {
+        if (handle_)
+            handle_.destroy();
+    }
+
+    // Awaiting starts the task, the result (or the exception) is taken by 'co_await'.
+    bool await_ready() const noexcept {
+        return !handle_ || handle_.done();
+    }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> const awaiting) noexcept {
+        handle_.promise().continuation = awaiting;
+        return handle_;
+    }
+    T await_resume() {
+        return handle_.promise().take();
+    }
+
+    /// Start the task without waiting, the callback gets the result
+    /// on the thread which finished the task (e.g. the engine's thread).
+    /// The task must not throw.
+    template<typename F>
+    void start(F&& callback) && {
+        [](Task task, std::decay_t<F> done) -> Detached {
+            if constexpr (std::is_void_v<T>) {
+                co_await task;
+                done();
+            }
+            else
+                done(co_await task);
+        }(std::move(*this), std::forward<F>(callback));
+    }
+    /// Start the task and block the calling thread until it's finished.
+    /// Don't call it on an engine's thread (in an async callback or a coroutine
+    /// resumed by the engine): the engine would wait for itself. Use 'co_await'.
+    T get() && {
+        std::promise<T> promise;
+        auto future = promise.get_future();
+        [](Task task, std::promise<T>& done) -> Detached {
+            try {
+                if constexpr (std::is_void_v<T>) {
+                    co_await task;
+                    done.set_value();
+                }
+                else
+                    done.set_value(co_await task);
+            }
+            catch (...) {
+                done.set_exception(std::current_exception());
+            }
+        }(std::move(*this), promise);
+        return future.get();
+    }
+};
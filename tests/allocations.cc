@@ -0,0 +1,81 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <cstdlib>
+#include <new>
+#include "curlex.h"
+#include "check.h"
+#include "server.h"
+
+// Test hook: counts allocations made with operator new by each thread
+// (the server's threads allocate too).
+namespace {
+    thread_local size_t allocations{};
+}
+
+void* operator new(size_t const size) {
+    ++allocations;
+    if (auto const p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* const p) noexcept {
+    std::free(p);
+}
+void operator delete(void* const p, size_t) noexcept {
+    std::free(p);
+}
+
+/// A steady-state GET (persistent handle, pooled body buffers) allocates only
+/// the headers block owned by the response: no control blocks, no copies.
+int main() {
+    TestServer server;
+    auto const pool = std::make_shared<BufferPool>();
+    Curlex cx;
+    cx.persistent().buffers(pool);
+    auto const req = Request().scheme("http").host(server.host()).endpoint("size").add_param("n", 1000).build();
+
+    for (int i = 0; i < 10; ++i)
+        if (auto response = cx.GET(req); response)
+            pool->give_back(std::move(*response).body());
+
+    for (int i = 0; i < 10; ++i) {
+        auto const before = allocations;
+        auto response = cx.GET(req);
+        auto const count = allocations - before;
+        CHECK(response && response->body().size() == 1000);
+        CHECK(count == 1);
+        if (count != 1)
+            fmt::print(stderr, "allocations of a GET: {}\n", count);
+        if (response)
+            pool->give_back(std::move(*response).body());
+    }
+    return check::failures;
+}
@@ -0,0 +1,101 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <array>
+#include <atomic>
+#include "curlex.h"
+#include "check.h"
+#include "server.h"
+
+Task<size_t> batch_inside(Curlex const& cx, std::span<Request const> requests) {
+    co_await cx.co_get(requests.front());
+    // Resumed on the engine's thread, a blocking batch is refused.
+    for (auto const& result : cx.execute_batch(requests, BatchLimits{.total = 4, .per_host = 2}))
+        if (result || result.error().code != CURLE_RECURSIVE_API_CALL)
+            co_return 0;
+    // The awaited batch runs on the engines, the coroutine waits for it.
+    auto const results = co_await cx.co_execute_batch({requests.begin(), requests.end()},
+                                                      BatchLimits{.total = 4, .per_host = 2});
+    size_t ok{};
+    for (size_t i = 0; i < results.size(); ++i)
+        ok += results[i] && results[i]->body().size() == i;
+    co_return ok;
+}
+
+/// Batches on many engine threads: every request completes exactly once,
+/// results come in order, and the batch outlives all of its completions
+/// (run it with CURLEX_SANITIZE=ON). Requests failing in their submit
+/// don't nest the scheduler, a blocking batch in a coroutine is refused
+/// and an awaited one runs on the engines.
+int main() {
+    std::array<TestServer, 8> servers;
+    std::vector<Request> requests;
+    for (int i = 0; i < 400; ++i)
+        requests.push_back(Request().scheme("http").host(servers[i % servers.size()].host())
+                                   .endpoint("size").add_param("n", i).build());
+
+    for (int round = 0; round < 20; ++round) {
+        Curlex cx;
+        cx.threads(4);
+        std::vector<std::atomic<int>> seen(requests.size());
+        std::atomic<size_t> ok{};
+        cx.execute_batch(requests, [&](size_t const index, Result<Response> result) {
+            seen[index].fetch_add(1);
+            if (result && result->body().size() == index)
+                ok.fetch_add(1);
+        }, BatchLimits{.total = 4, .per_host = 1});
+        CHECK(ok == requests.size());
+        for (auto const& count : seen)
+            CHECK(count == 1);
+    }
+
+    Curlex cx;
+    cx.threads(4);
+    auto const results = cx.execute_batch(requests, BatchLimits{.total = 16, .per_host = 2});
+    CHECK(results.size() == requests.size());
+    for (size_t i = 0; i < results.size(); ++i)
+        CHECK(results[i] && results[i]->body().size() == i);
+    CHECK(cx.execute_batch(std::span<Request const>{}).empty());
+    CHECK(batch_inside(cx, std::span(requests).first(20)).get() == 20);
+    CHECK(cx.co_execute_batch(requests, BatchLimits{.total = 16, .per_host = 2}).get().size() == requests.size());
+    CHECK(cx.co_execute_batch({}).get().empty());
+
+    // Every submit completes at once (as with a stopped engine).
+    std::vector<Request> many(100'000, requests.front());
+    size_t failed{};
+    Batch batch(many, Method::GET, BatchLimits{}, [&](size_t, Result<Response> result) {
+        failed += !result;
+    }, [](Method, Request const&, std::function<void(Result<Response>)> const& callback) {
+        callback(Error{CURLE_ABORTED_BY_CALLBACK, "STOPPED"});
+    });
+    batch.run();
+    CHECK(failed == many.size());
+    return check::failures;
+}
@@ -0,0 +1,77 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "curlex.h"
+#include "buffers.h"
+#include "check.h"
+#include "server.h"
+
+/// The reserved capacity is limited whatever Content-Length the server sends.
+/// Compressed bodies: the Content-Encoding of the final response (not of
+/// an interim one) is detected, so its length is taken as a lower bound;
+/// decoded bodies arrive whole on both paths, with and without a pool.
+int main() {
+    CHECK(buffers::encoded("HTTP/1.1 200 OK\r\nContent-Encoding: gzip\r\nContent-Length: 10\r\n\r\n"));
+    CHECK(buffers::encoded("HTTP/1.1 200 OK\r\ncontent-encoding:br\r\n\r\n"));
+    CHECK(!buffers::encoded("HTTP/1.1 200 OK\r\nContent-Encoding: identity\r\n\r\n"));
+    CHECK(!buffers::encoded("HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\n"));
+    CHECK(!buffers::encoded("HTTP/1.1 301 Moved\r\nContent-Encoding: gzip\r\n\r\n"
+                            "HTTP/1.1 200 OK\r\nContent-Length: 10\r\n\r\n"));
+    CHECK(buffers::encoded("HTTP/1.1 100 Continue\r\n\r\n"
+                           "HTTP/1.1 200 OK\r\nContent-Encoding: gzip\r\n\r\n"));
+    CHECK(!buffers::encoded(""));
+
+    // The size announced by the server is only a hint, a hostile one doesn't reserve more.
+    CHECK(buffers::reserve_size(-1, false) == 0);
+    CHECK(buffers::reserve_size(0, true) == 0);
+    CHECK(buffers::reserve_size(1000, false) == 1000);
+    CHECK(buffers::reserve_size(9223372036854775807, false) == buffers::MAX_RESERVE);
+    CHECK(buffers::reserve_size(1000, true) == 1000 * buffers::ENCODED_GROWTH);
+    CHECK(buffers::reserve_size(buffers::MAX_RESERVE / 2, true) == buffers::MAX_RESERVE);
+    CHECK(buffers::reserve_size(9223372036854775807, true) == buffers::MAX_RESERVE);
+
+    TestServer server;
+    auto const req = Request().scheme("http").host(server.host()).endpoint("gzip").build();
+    auto const text = TestServer::gzip_text();
+    for (bool const pooled : {false, true}) {
+        Curlex cx;
+        if (pooled)
+            cx.buffers(std::make_shared<BufferPool>());
+        for (int i = 0; i < 3; ++i) {
+            auto const response = cx.GET(req);
+            CHECK(response && response->body() == text);
+            if (response)
+                CHECK(response->stats().decoded == static_cast<int64_t>(text.size()));
+            auto const async = cx.async_get(req).get();
+            CHECK(async && async->body() == text);
+        }
+    }
+    return check::failures;
+}
@@ -0,0 +1,115 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "curlex.h"
+#include "check.h"
+#include "server.h"
+
+/// Fresh hits don't touch the network and share the body and the headers;
+/// variants of a URL ('Vary') are kept side by side; clones share the cache.
+/// Moving the body out of a shared response copies it only if it has other owners.
+/// Stale entries are revalidated (a 304 returns the cached body), those without
+/// validators are dropped and fetched again.
+int main() {
+    TestServer server;
+    auto const cache = std::make_shared<ResponseCache>();
+    Curlex cx;
+    cx.cache(cache);
+    auto const base = Request().scheme("http").host(server.host()).endpoint("vary").build();
+    auto a = Request(base).add_header("Accept", "text/a");
+    auto b = Request(base).add_header("accept", "text/b");
+
+    for (int i = 0; i < 3; ++i) {
+        auto const ra = cx.GET(a);
+        auto const rb = cx.GET(b);
+        CHECK(ra && ra->body() == "text/a");
+        CHECK(rb && rb->body() == "text/b");
+    }
+    CHECK(server.requests() == 2);
+    CHECK(cache->size() == 2);
+
+    auto const h0 = cx.GET(a);
+    auto const h1 = cx.GET(a);
+    CHECK(h0 && h1);
+    if (h0 && h1) {
+        CHECK(h0->body().data() == h1->body().data());
+        CHECK(h0->headers_raw().data() == h1->headers_raw().data());
+        CHECK(h1->header("vary") == "Accept");
+    }
+
+    // The cache still holds the body: it's copied, not taken.
+    if (auto hit = cx.GET(a)) {
+        auto const body = std::move(*hit).body();
+        CHECK(body == "text/a");
+        auto const again = cx.GET(a);
+        CHECK(again && again->body() == "text/a");
+    }
+    // The last owner takes the body without a copy.
+    Response alone(200);
+    alone.body(std::string(100, 'z')).share();
+    auto const data = alone.body().data();
+    auto const taken = std::move(alone).body();
+    CHECK(taken.data() == data && taken.size() == 100);
+
+    auto const clone = cx.clone();
+    auto const hit = clone.GET(b);
+    CHECK(hit && hit->body() == "text/b");
+    CHECK(server.requests() == 2);
+
+    // 'max-age=0' with a validator: every use is a conditional request answered with 304.
+    for (auto const endpoint : {"etag", "modified"}) {
+        auto const req = Request().scheme("http").host(server.host()).endpoint(endpoint).build();
+        auto const requests = server.requests();
+        auto const not_modified = server.not_modified();
+        auto const first = cx.GET(req);
+        CHECK(first && first->code() == 200 && first->body() == "validated");
+        for (int i = 0; i < 3; ++i) {
+            auto revalidated = cx.GET(req);
+            CHECK(revalidated && revalidated->code() == 200);
+            // Taking the body leaves the cached one intact.
+            if (revalidated)
+                CHECK(std::move(*revalidated).body() == "validated");
+        }
+        CHECK(server.requests() - requests == 4);
+        CHECK(server.not_modified() - not_modified == 3);
+    }
+
+    // Stale without validators: dropped, fetched again unconditionally and stored anew.
+    auto const short_lived = Request().scheme("http").host(server.host()).endpoint("max-age").add_param("s", 1).build();
+    CHECK(cx.GET(short_lived) && cx.GET(short_lived));
+    auto const requests = server.requests();
+    auto const size = cache->size();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+    auto const refetched = cx.GET(short_lived);
+    CHECK(refetched && refetched->body() == "ok");
+    CHECK(server.requests() - requests == 1);
+    CHECK(cache->size() == size);
+    return check::failures;
+}
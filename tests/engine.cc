@@ -0,0 +1,92 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <atomic>
+#include "curlex.h"
+#include "check.h"
+#include "server.h"
+
+using namespace std::chrono_literals;
+
+Task<size_t> two_in_row(Curlex const& cx, Request const& req) {
+    auto const first = co_await cx.co_get(req);
+    auto const second = co_await cx.co_get(req);
+    co_return (first ? first->body().size() : 0) + (second ? second->body().size() : 0);
+}
+
+/// Coroutines and callbacks on the epoll-driven engines.
+/// Delayed requests (e.g. cancelled hedge legs) aren't load until they start.
+int main() {
+    TestServer server;
+    auto const req = Request().scheme("http").host(server.host()).endpoint("size").add_param("n", 10).build();
+
+    for (size_t const threads : {1, 4}) {
+        Curlex cx;
+        cx.threads(threads);
+        CHECK(two_in_row(cx, req).get() == 20);
+
+        // Many outstanding requests cost no threads.
+        std::atomic<size_t> ok{}, done{};
+        size_t const n = 500;
+        for (size_t i = 0; i < n; ++i)
+            cx.co_get(Request().scheme("http").host(server.host()).endpoint("sleep").add_param("ms", 20).build())
+                    .start([&](Result<Response> const& result) {
+                        if (result)
+                            ok.fetch_add(1);
+                        done.fetch_add(1);
+                        done.notify_one();
+                    });
+        for (auto d = done.load(); d < n; d = done.load())
+            done.wait(d);
+        CHECK(ok == n);
+
+        // curl's timer drives timeouts.
+        auto const slow = cx.co_get(Request().scheme("http").host(server.host()).endpoint("sleep")
+                                            .add_param("ms", 2000).build().timeout(200ms)).get();
+        CHECK(!slow && slow.error().code == CURLE_OPERATION_TIMEDOUT);
+    }
+
+    Engine engine;
+    auto const cancel = std::make_shared<std::atomic<bool>>(false);
+    std::atomic<int> delivered{};
+    auto const count = [&delivered](Result<Response> const&) {
+        delivered.fetch_add(1);
+    };
+    for (int i = 0; i < 100; ++i)
+        engine.submit(Method::GET, req, count, 300ms, cancel);
+    engine.submit(Method::GET, req, count, 100ms);
+    std::this_thread::sleep_for(50ms);
+    cancel->store(true);
+    CHECK(engine.load() == 0);
+    std::this_thread::sleep_for(400ms);
+    CHECK(delivered == 101);
+    CHECK(engine.load() == 0);
+    return check::failures;
+}
@@ -0,0 +1,84 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "curlex.h"
+#include "check.h"
+#include "server.h"
+
+/// Headers are parsed on the first lookup, names are case-insensitive, and
+/// only the final response of several headers blocks (100 Continue,
+/// redirects) counts.
+int main() {
+    Response response(200);
+    response.headers("HTTP/1.1 100 Continue\r\n\r\n"
+                     "HTTP/1.1 302 Found\r\nLocation: /next\r\nX-Old: 1\r\n\r\n"
+                     "HTTP/1.1 200 OK\r\n"
+                     "Content-Type: text/plain\r\n"
+                     "set-cookie: a=1\r\n"
+                     "Set-Cookie: b=2\r\n"
+                     "X-Spaces:    padded value  \r\n"
+                     "\r\n");
+    CHECK(response.header("content-type") == "text/plain");
+    CHECK(response.header("CONTENT-TYPE") == "text/plain");
+    CHECK(response.header("Set-Cookie") == "a=1");
+    CHECK(response.header("x-spaces") == "padded value");
+    CHECK(!response.header("location"));
+    CHECK(!response.header("x-old"));
+    CHECK(!response.header("missing"));
+    auto const fields = response.header_fields();
+    CHECK(fields.size() == 4);
+    CHECK(std::is_sorted(fields.begin(), fields.end(), [](auto const& a, auto const& b) {
+        return shared::iless(a.first, b.first);
+    }));
+    CHECK(response.headers().size() == 4);
+
+    // New headers replace the parsed ones.
+    response.headers("HTTP/1.1 200 OK\r\nETag: \"v2\"\r\n\r\n");
+    CHECK(response.header("etag") == "\"v2\"");
+    CHECK(!response.header("content-type"));
+
+    // Copies keep their own views.
+    Response copy = response;
+    response.headers("HTTP/1.1 200 OK\r\n\r\n");
+    CHECK(copy.header("ETag") == "\"v2\"");
+
+    // From the server: an interim 100 Continue before the final response.
+    TestServer server;
+    Curlex cx;
+    auto const posted = cx.POST(Request().scheme("http").host(server.host()).endpoint("echo").build()
+                                        .add_header("Expect", "100-continue").body(std::string(2048, 'b')));
+    CHECK(posted && posted->body().size() == 2048);
+    if (posted) {
+        CHECK(posted->headers_raw().starts_with("HTTP/1.1 100 Continue"));
+        CHECK(posted->header("Content-Length") == "2048");
+        CHECK(posted->header("content-type") == "text/plain");
+    }
+    return check::failures;
+}
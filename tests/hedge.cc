@@ -0,0 +1,100 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <thread>
+#include <future>
+#include "curlex.h"
+#include "check.h"
+#include "server.h"
+
+using namespace std::chrono_literals;
+
+Task<bool> hedged_inside(Curlex const& cx, Request const& req, Request const& slow) {
+    auto const first = co_await cx.co_get(req);
+    // Resumed on the engine's thread, a blocking hedge is refused.
+    auto const blocking = cx.GET(Request(req).hedge(HedgePolicy{.delay = 50ms}));
+    if (blocking || blocking.error().code != CURLE_RECURSIVE_API_CALL)
+        co_return false;
+    // An awaited one races on the engine.
+    auto const hedged = co_await cx.co_get(Request(slow).hedge(HedgePolicy{.delay = 50ms}));
+    co_return first && hedged && hedged->code() == 200;
+}
+
+/// Hedged requests: the second leg starts after the delay and the first
+/// response wins; on an engine's thread a hedge is awaited, not blocking.
+/// Many delayed legs and retries after backoff wait in the engine at once.
+int main() {
+    TestServer server;
+    auto const req = Request().scheme("http").host(server.host()).endpoint("size").add_param("n", 10).build();
+
+    for (size_t const threads : {1, 4}) {
+        Curlex cx;
+        cx.threads(threads);
+        auto const slow = Request().scheme("http").host(server.host()).endpoint("sleep").add_param("ms", 300).build();
+        // In a coroutine: the plain request and both legs of the awaited hedge
+        // (the server counts the cancelled leg when it's finished).
+        auto const inside = server.requests();
+        CHECK(hedged_inside(cx, req, slow).get());
+        std::this_thread::sleep_for(400ms);
+        CHECK(server.requests() - inside == 3);
+
+        // The first leg is slower than the delay: both legs go out.
+        auto const before = server.requests();
+        auto const hedged = cx.GET(Request(slow).hedge(HedgePolicy{.delay = 50ms}));
+        CHECK(hedged && hedged->code() == 200);
+
+        // Fast responses: the second legs are never sent.
+        auto const fast = server.requests();
+        for (int i = 0; i < 20; ++i)
+            CHECK(cx.GET(Request(req).hedge(HedgePolicy{.delay = 500ms})));
+        CHECK(server.requests() - fast == 20);
+        CHECK(fast - before <= 2);
+
+        // Hundreds of hedges in flight, most second legs are cancelled before they're due.
+        std::vector<std::future<Result<Response>>> futures;
+        for (int i = 0; i < 300; ++i)
+            futures.push_back(cx.async_get(Request(slow).hedge(HedgePolicy{.delay = std::chrono::milliseconds(20 + i)})));
+        size_t ok{};
+        for (auto& future : futures)
+            ok += future.get().has_value();
+        CHECK(ok == futures.size());
+
+        // Each timed out attempt is retried after its backoff
+        // (after the server finished the cancelled legs).
+        std::this_thread::sleep_for(400ms);
+        auto const start = server.requests();
+        auto const retried = cx.GET(Request().scheme("http").host(server.host()).endpoint("sleep").add_param("ms", 300)
+                                            .build().timeout(100ms).retry(RetryPolicy{.attempts = 3, .backoff = 10ms}));
+        CHECK(!retried && retried.error().code == CURLE_OPERATION_TIMEDOUT);
+        std::this_thread::sleep_for(400ms);
+        CHECK(server.requests() - start == 3);
+    }
+    return check::failures;
+}
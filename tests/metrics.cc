@@ -0,0 +1,80 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <thread>
+#include "metrics.h"
+#include "check.h"
+
+/// Counters recorded on many threads add up, also after the threads exited
+/// (their shards are released); a long-lived thread recording into many
+/// short-lived registries gets a fresh shard for each of them. A recent
+/// percentile is cached by the thread for a while.
+int main() {
+    Metrics metrics;
+    Stats stats{};
+    stats.total_us = 1500;
+    stats.downloaded = 10;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t)
+        threads.emplace_back([&] {
+            for (int i = 0; i < 1000; ++i)
+                metrics.record(Method::GET, "a:80", 200, stats);
+        });
+    for (auto& thread : threads)
+        thread.join();
+    auto const snapshot = metrics.snapshot();
+    CHECK(snapshot.connections_new == 8000);
+    CHECK(snapshot.downloaded == 80'000);
+    CHECK(snapshot.hosts.at("a:80").count == 8000);
+    CHECK(snapshot.hosts.at("a:80").max_us == 1500);
+    CHECK(metrics.shards() == 0);
+    CHECK(metrics.percentile("a:80", 0.5).has_value());
+
+    Metrics fresh;
+    CHECK(!fresh.recent_percentile("c:80", 0.5, 2));
+    fresh.record(Method::GET, "c:80", 200, stats);
+    fresh.record(Method::GET, "c:80", 200, stats);
+    CHECK(fresh.shards() == 1);
+    CHECK(fresh.percentile("c:80", 0.5, 2).has_value());
+    // Not refreshed yet, then it is.
+    CHECK(!fresh.recent_percentile("c:80", 0.5, 2));
+    std::this_thread::sleep_for(std::chrono::milliseconds(150));
+    CHECK(fresh.recent_percentile("c:80", 0.5, 2) == fresh.percentile("c:80", 0.5, 2));
+
+    for (int i = 0; i < 10'000; ++i) {
+        auto const registry = std::make_unique<Metrics>();
+        registry->record(Method::GET, "b:80", 200, stats);
+        registry->record(Method::GET, "b:80", 200, stats);
+        CHECK(registry->snapshot().connections_new == 2);
+    }
+    metrics.record(Method::GET, "a:80", 200, stats);
+    CHECK(metrics.snapshot().connections_new == 8001);
+    return check::failures;
+}
@@ -0,0 +1,79 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "curlex.h"
+#include "check.h"
+#include "server.h"
+
+/// Requests of different methods, headers and timeouts one after another on
+/// one handle: only the options which differ are applied in persistent mode,
+/// so nothing of the previous request may leak into the next one.
+int main() {
+    TestServer server;
+    auto const req = Request().scheme("http").host(server.host()).endpoint("request").build();
+    auto const echo = Request().scheme("http").host(server.host()).endpoint("echo").build();
+
+    for (bool const persistent : {false, true}) {
+        Curlex cx;
+        cx.persistent(persistent);
+        auto const starts = [](Result<Response> const& response, std::string_view const line) {
+            return response && response->code() == 200 && response->body().starts_with(line);
+        };
+
+        CHECK(starts(cx.GET(req), "GET /request HTTP/1.1"));
+        auto const posted = cx.POST(Request(echo).body("posted"));
+        CHECK(posted && posted->body() == "posted");
+        CHECK(starts(cx.GET(req), "GET /request HTTP/1.1"));
+        auto const put = cx.PUT(Request(echo).body("put"));
+        CHECK(put && put->body() == "put");
+        CHECK(starts(cx.DELETE(req), "DELETE /request HTTP/1.1"));
+        CHECK(starts(cx.PATCH(Request(req).body("x")), "PATCH /request HTTP/1.1"));
+
+        // HEAD after POST: no body is expected (nor waited for).
+        CHECK(cx.POST(Request(echo).body("before head")));
+        auto const head = cx.HEAD(req);
+        CHECK(head && head->code() == 200 && head->body().empty());
+        CHECK(starts(cx.GET(req), "GET /request HTTP/1.1"));
+        CHECK(starts(cx.POST(Request(req).body("after head")), "POST /request HTTP/1.1"));
+
+        // Headers of one request aren't sent with the next one.
+        auto const with = cx.GET(Request(req).add_header("X-Only-Once", "1"));
+        CHECK(with && with->body().find("X-Only-Once:1") != std::string::npos);
+        auto const without = cx.GET(req);
+        CHECK(without && without->body().find("X-Only-Once") == std::string::npos);
+
+        // A timeout of one request doesn't apply to the next one.
+        auto const sleep = Request().scheme("http").host(server.host()).endpoint("sleep").add_param("ms", 300).build();
+        auto const timed_out = cx.GET(Request(sleep).timeout(std::chrono::milliseconds(100)));
+        CHECK(!timed_out && timed_out.error().code == CURLE_OPERATION_TIMEDOUT);
+        CHECK(cx.GET(sleep));
+    }
+    return check::failures;
+}
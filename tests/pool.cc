@@ -0,0 +1,91 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/18
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <atomic>
+#include <optional>
+#include "pool.h"
+#include "check.h"
+#include "server.h"
+
+using namespace std::chrono_literals;
+
+/// Leased handles go back to the pool and keep their connections, share
+/// the DNS and TLS session caches and the metrics; at capacity a lease waits
+/// for a returned handle; a lease may outlive its pool.
+int main() {
+    TestServer server;
+    auto const req = Request().scheme("http").host(server.host()).endpoint("size").add_param("n", 10).build();
+    {
+        CurlexPool pool(2);
+        Curlex const* first{};
+        {
+            auto const lease = pool.lease();
+            first = &*lease;
+            CHECK(lease->GET(req));
+        }
+        // The most recently returned handle is leased first, with its open connection.
+        {
+            auto const lease = pool.lease();
+            CHECK(&*lease == first);
+            CHECK(lease->GET(req));
+            auto const other = pool.lease();
+            CHECK(&*other != first);
+            CHECK(lease->share() && lease->share() == other->share());
+            CHECK(other->GET(req));
+        }
+        CHECK(server.connections() == 2);
+        auto const snapshot = pool.metrics().snapshot();
+        CHECK(snapshot.connections_new == 2);
+        CHECK(snapshot.connections_reused == 1);
+
+        auto const a = pool.lease();
+        std::optional<CurlexPool::Lease> b;
+        b.emplace(pool.lease());
+        std::atomic<bool> leased{};
+        std::thread waiter([&] {
+            auto const c = pool.lease();
+            leased = true;
+        });
+        std::this_thread::sleep_for(100ms);
+        CHECK(!leased);
+        b.reset();
+        waiter.join();
+        CHECK(leased);
+    }
+
+    std::optional<CurlexPool::Lease> survivor;
+    {
+        CurlexPool pool;
+        survivor.emplace(pool.lease());
+    }
+    CHECK((*survivor)->GET(req));
+    survivor.reset();
+    return check::failures;
+}
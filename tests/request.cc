@@ -0,0 +1,113 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "curlex.h"
+#include "check.h"
+#include "server.h"
+
+struct Item {
+    int64_t id{};
+    std::string name{};
+    std::vector<std::string> tags{};
+};
+
+/// Params and headers: policies of repeated keys, case-insensitive header names
+/// (below and above the size where the index is used), copies of requests.
+/// Typed JSON requests: values go out as the body, responses are parsed,
+/// a body which isn't the expected JSON and an error status are errors.
+int main() {
+    for (int const count : {4, 300}) {
+        Request req;
+        req.scheme("http").host("host").endpoint("x");
+        for (int i = 0; i < count; ++i)
+            req.add_param(fmt::format("k{}", i), i);
+        req.add_param("k1", "replaced", Request::Policy::Replace);
+        req.add_param("k2", "appended", Request::Policy::Append);
+        req.add_param("k3", "rejected");
+        req.build();
+        auto const& url = req.url();
+        CHECK(url.find("k1=replaced") != std::string::npos);
+        CHECK(url.find("k1=1&") == std::string::npos);
+        CHECK(url.find("k2=2&") != std::string::npos);
+        CHECK(url.find("k2=appended") != std::string::npos);
+        CHECK(url.find("k3=rejected") == std::string::npos);
+
+        Request copy(req);
+        copy.add_param(fmt::format("k{}", count - 1), "last", Request::Policy::Replace).build();
+        CHECK(copy.url().find(fmt::format("k{}=last", count - 1)) != std::string::npos);
+        CHECK(req.url().find(fmt::format("k{}=last", count - 1)) == std::string::npos);
+    }
+
+    for (int const count : {2, 50}) {
+        Request req;
+        for (int i = 0; i < count; ++i)
+            req.add_header(fmt::format("X-Header-{}", i), i);
+        req.add_header("content-type", "a");
+        req.add_header("Content-Type", "b", Request::Policy::Replace);
+        req.add_header("CONTENT-TYPE", "c");
+        req.add_header("x-header-1", "d", Request::Policy::Replace);
+        CHECK(req.headers().size() == static_cast<size_t>(count) + 1);
+        for (auto const& [k, v] : req.headers()) {
+            if (k == "content-type")
+                CHECK(v == "b");
+            if (k == "X-Header-1")
+                CHECK(v == "d");
+        }
+    }
+
+    TestServer server;
+    Curlex cx;
+    auto const base = Request().scheme("http").host(server.host());
+    Item const item{42, "pen", {"x", "y"}};
+
+    auto const got = cx.get_json<Item>(Request(base).endpoint("json").build());
+    CHECK(got && got->id == 7 && got->name == "book" && got->tags == std::vector<std::string>({"a", "b"}));
+    // The echoed body is the serialized value.
+    auto const echoed = cx.post_json<Item>(Request(base).endpoint("echo").build(), item);
+    CHECK(echoed && echoed->id == item.id && echoed->name == item.name && echoed->tags == item.tags);
+    auto const put = cx.put_json<Item>(Request(base).endpoint("echo").build(), item);
+    CHECK(put && put->name == item.name);
+    auto const head = cx.POST(Request(base).endpoint("request").build().json(item));
+    CHECK(head && head->body().find("application/json") != std::string::npos);
+
+    auto const response = cx.GET(Request(base).endpoint("json").build());
+    CHECK(response && response->json<Item>() && response->json<Item>()->id == 7);
+
+    // "ok" isn't an Item.
+    auto const malformed = cx.get_json<Item>(Request(base).endpoint("text").build());
+    CHECK(!malformed && malformed.error().code == CURLE_WEIRD_SERVER_REPLY);
+    if (!malformed)
+        CHECK(std::string_view(malformed.error().stage) == "JSON");
+    auto const status = cx.get_json<Item>(Request(base).endpoint("status").add_param("code", 404).build());
+    CHECK(!status && status.error().code == CURLE_HTTP_RETURNED_ERROR);
+    auto const co_got = cx.co_get_json<Item>(Request(base).endpoint("json").build()).get();
+    CHECK(co_got && co_got->name == "book");
+    return check::failures;
+}
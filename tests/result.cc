@@ -0,0 +1,99 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "curlex.h"
+#include "check.h"
+#include "server.h"
+
+using namespace std::chrono_literals;
+
+/// A port nobody listens on.
+static uint16_t closed_port() {
+    auto const socket = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t size = sizeof(addr);
+    bind(socket, reinterpret_cast<sockaddr*>(&addr), size);
+    getsockname(socket, reinterpret_cast<sockaddr*>(&addr), &size);
+    close(socket);
+    return ntohs(addr.sin_port);
+}
+
+/// Failed requests return the curl's code, the stage which failed and the time
+/// it took, on the sync and async paths; HTTP errors are responses, not errors.
+int main() {
+    TestServer server;
+    Curlex cx;
+    auto const refused = Request().scheme("http").host(fmt::format("127.0.0.1:{}", closed_port())).endpoint("x").build();
+    auto const unsupported = Request().scheme("nope").host(server.host()).endpoint("x").build();
+    auto const slow = Request().scheme("http").host(server.host()).endpoint("sleep").add_param("ms", 500).build()
+            .timeout(100ms);
+
+    auto const check_error = [](Result<Response> const& result, CURLcode const code) {
+        CHECK(!result);
+        if (result)
+            return;
+        CHECK(result.error().code == code);
+        CHECK(std::string_view(result.error().stage) == "PERFORM");
+        CHECK(result.error().elapsed_us > 0);
+        CHECK(result.error().message().starts_with("PERFORM: "));
+    };
+    check_error(cx.GET(refused), CURLE_COULDNT_CONNECT);
+    check_error(cx.async_get(refused).get(), CURLE_COULDNT_CONNECT);
+    check_error(cx.GET(unsupported), CURLE_UNSUPPORTED_PROTOCOL);
+    check_error(cx.async_get(unsupported).get(), CURLE_UNSUPPORTED_PROTOCOL);
+    check_error(cx.GET(slow), CURLE_OPERATION_TIMEDOUT);
+    check_error(cx.async_get(slow).get(), CURLE_OPERATION_TIMEDOUT);
+
+    auto const timed_out = cx.GET(slow);
+    CHECK(!timed_out || timed_out.error().elapsed_us >= 100'000);
+
+    // value() of an error throws with the error.
+    auto failed = cx.GET(refused);
+    bool thrown{};
+    try {
+        [[maybe_unused]] auto const& value = failed.value();
+    } catch (BadResultAccess const& e) {
+        thrown = e.error().code == CURLE_COULDNT_CONNECT;
+    }
+    CHECK(thrown);
+    CHECK(failed.value_or(Response(0)).code() == 0);
+
+    // HTTP status codes are responses.
+    for (long const code : {201L, 404L, 503L}) {
+        auto const req = Request().scheme("http").host(server.host()).endpoint("status").add_param("code", code).build();
+        auto const sync = cx.GET(req);
+        CHECK(sync && sync->code() == code);
+        auto const async = cx.async_get(req).get();
+        CHECK(async && async->code() == code);
+    }
+    return check::failures;
+}
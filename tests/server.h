@@ -0,0 +1,343 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+#include <cctype>
+#include <cstdlib>
+#include <charconv>
+#include <string_view>
+#include <fmt/core.h>
+#include <poll.h>
+#include <unistd.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
+
+/// Minimal HTTP/1.1 server on the loopback (keep-alive, a thread per connection),
+/// so tests and benchmarks don't depend on the network. Routes:
+///   /sleep?ms=N  - responds after N milliseconds,
+///   /size?n=N    - body of N bytes,
+///   /vary        - body is the Accept header, 'Vary: Accept', 'max-age=60',
+///   /status?code=N - responds with the status code N,
+///   /request     - body is the head of the request (request line and headers),
+///   /gzip        - gzip encoded 'TestServer::gzip_text()' (2680 bytes, 469 encoded),
+///   /etag, /modified - body "validated" with an ETag (Last-Modified) and 'max-age=0',
+///                  304 if the request's If-None-Match (If-Modified-Since) matches it,
+///   /max-age?s=N - body "ok", 'max-age=N' without validators,
+///   /json        - body '{"id":7,"name":"book","tags":["a","b"]}' (application/json),
+///   anything else - body "ok" (a POST/PUT body is echoed, also a chunked one).
+class TestServer {
+    int listener_{-1};
+    uint16_t port_{};
+    std::atomic<bool> stop_{};
+    std::atomic<size_t> connections_{};
+    std::atomic<size_t> requests_{};
+    std::atomic<size_t> not_modified_{};
+    std::mutex mutex_{};
+    std::vector<int> sockets_{};
+    std::vector<std::thread> threads_{};
+    std::thread acceptor_;
+public:
+    TestServer() {
+        listener_ = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        int const one{1};
+        setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t size = sizeof(addr);
+        if (bind(listener_, reinterpret_cast<sockaddr*>(&addr), size) < 0 || listen(listener_, 1024) < 0) {
+            fmt::print(stderr, "TestServer: can't listen\n");
+            std::exit(2);
+        }
+        getsockname(listener_, reinterpret_cast<sockaddr*>(&addr), &size);
+        port_ = ntohs(addr.sin_port);
+        acceptor_ = std::thread(&TestServer::accept_loop, this);
+    }
+    ~TestServer() {
+        stop_ = true;
+        acceptor_.join();
+        close(listener_);
+        {
+            std::lock_guard lock(mutex_);
+            for (auto const socket : sockets_)
+                shutdown(socket, SHUT_RDWR);
+        }
+        for (auto& thread : threads_)
+            thread.join();
+    }
+    TestServer(TestServer const&) = delete;
+    TestServer& operator=(TestServer const&) = delete;
+
+    /// Host for requests, e.g. "127.0.0.1:40123".
+    [[nodiscard]] std::string host() const {
+        return fmt::format("127.0.0.1:{}", port_);
+    }
+    /// Body of /gzip after decoding: JSON-like text, compressed about 5.7 times.
+    [[nodiscard]] static std::string gzip_text() {
+        std::string text;
+        for (int i = 0; i < 100; ++i)
+            text += fmt::format(R"({{"id":{},"name":"item {}"}},)", i, i);
+        return text;
+    }
+    /// Number of accepted connections.
+    [[nodiscard]] size_t connections() const noexcept {
+        return connections_;
+    }
+    /// Number of served requests.
+    [[nodiscard]] size_t requests() const noexcept {
+        return requests_;
+    }
+    /// Number of '304 Not Modified' responses.
+    [[nodiscard]] size_t not_modified() const noexcept {
+        return not_modified_;
+    }
+
+private:
+    void accept_loop() {
+        while (!stop_) {
+            pollfd pfd{listener_, POLLIN, 0};
+            if (poll(&pfd, 1, 50) <= 0)
+                continue;
+            auto const socket = accept4(listener_, nullptr, nullptr, SOCK_CLOEXEC);
+            if (socket < 0)
+                continue;
+            int const one{1};
+            setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            ++connections_;
+            std::lock_guard lock(mutex_);
+            sockets_.push_back(socket);
+            threads_.emplace_back(&TestServer::serve, this, socket);
+        }
+    }
+
+    void serve(int const socket) {
+        std::string in;
+        for (;;) {
+            auto end = in.find("\r\n\r\n");
+            if (end == std::string::npos) {
+                if (!receive(socket, in))
+                    break;
+                continue;
+            }
+            std::string_view head{in.data(), end + 4};
+            if (!header(head, "expect").empty() && !send_all(socket, "HTTP/1.1 100 Continue\r\n\r\n"))
+                break;
+            std::string body;
+            size_t consumed{};
+            if (header(head, "transfer-encoding") == "chunked") {
+                // Chunks: size in hex, CRLF, data, CRLF; the last one is empty.
+                size_t pos = end + 4;
+                for (;;) {
+                    auto line_end = in.find("\r\n", pos);
+                    for (; line_end == std::string::npos; line_end = in.find("\r\n", pos))
+                        if (!receive(socket, in))
+                            return finish(socket);
+                    size_t n{};
+                    std::from_chars(in.data() + pos, in.data() + line_end, n, 16);
+                    while (in.size() < line_end + 2 + n + 2)
+                        if (!receive(socket, in))
+                            return finish(socket);
+                    body.append(in, line_end + 2, n);
+                    pos = line_end + 2 + n + 2;
+                    if (!n)
+                        break;
+                }
+                consumed = pos;
+            } else {
+                auto const length = number(header(head, "content-length"));
+                while (in.size() < end + 4 + length)
+                    if (!receive(socket, in))
+                        return finish(socket);
+                body.assign(in, end + 4, length);
+                consumed = end + 4 + length;
+            }
+            head = std::string_view{in.data(), end + 4};
+            auto const out = respond(head, body);
+            in.erase(0, consumed);
+            ++requests_;
+            if (out.starts_with("HTTP/1.1 304 "))
+                ++not_modified_;
+            if (!send_all(socket, out))
+                break;
+        }
+        finish(socket);
+    }
+
+    /// Append the next received data, false if the connection is closed.
+    static bool receive(int const socket, std::string& in) {
+        char chunk[16 * 1024];
+        auto const n = read(socket, chunk, sizeof(chunk));
+        if (n <= 0)
+            return false;
+        in.append(chunk, static_cast<size_t>(n));
+        return true;
+    }
+
+    void finish(int const socket) {
+        std::lock_guard lock(mutex_);
+        std::erase(sockets_, socket);
+        close(socket);
+    }
+
+    static std::string respond(std::string_view const head, std::string_view const body) {
+        auto const line_end = head.find("\r\n");
+        auto const line = head.substr(0, line_end);
+        auto const method = line.substr(0, line.find(' '));
+        auto const target = line.substr(method.size() + 1, line.rfind(' ') - method.size() - 1);
+        auto const path = target.substr(0, target.find('?'));
+
+        std::string content{"ok"};
+        std::string extra{};
+        size_t status{200};
+        if (path == "/sleep")
+            std::this_thread::sleep_for(std::chrono::milliseconds(number(param(target, "ms"))));
+        else if (path == "/size")
+            content.assign(number(param(target, "n")), 'x');
+        else if (path == "/vary") {
+            content = std::string(header(head, "accept"));
+            extra = "Vary: Accept\r\nCache-Control: max-age=60\r\n";
+        }
+        else if (path == "/status")
+            status = number(param(target, "code"));
+        else if (path == "/request")
+            content = std::string(head);
+        else if (path == "/gzip") {
+            static constexpr char gzipped[] =
+                    "\x1f\x8b\x08\x00\x00\x00\x00\x00\x02\x03\x5d\xd6\x3b\x6e\x18\x31\x0c\x00\xd1\xab\x04\x5b\xbb\xb0"
+                    "\x28\x4a\xa2\x7c\x9b\x00\x76\xe1\xc2\xa9\xd2\x19\xb9\x7b\x90\x14\x3b\xda\xa9\xa7\xe2\x83\x3e\xfc"
+                    "\xbe\x3e\xdf\xaf\xb7\xd7\x97\xeb\xd7\xcf\xaf\x8f\xeb\xed\xfa\xfc\xfd\xf1\xf5\xe3\xf5\xfa\xf3\xf2"
+                    "\xfd\x3f\xb4\x67\x68\x77\x88\x67\x88\x3b\xf4\x67\xe8\x77\xc8\x67\xc8\x3b\x8c\x67\x18\x77\x98\xcf"
+                    "\x30\xef\xb0\x9e\x61\xdd\xa1\x9e\xa1\xee\xb0\x9f\x61\x33\xa0\x46\x6f\xc7\xec\x1e\x9e\xe9\x9b\xc6"
+                    "\x6f\xcc\xdf\x04\xd0\x10\x68\x22\x68\x18\x34\x21\x34\x14\x9a\x18\x1a\x0e\x4d\x10\x0d\x89\x26\x8a"
+                    "\x86\x45\x13\x46\x43\x23\xa4\x11\x68\x84\x34\xe2\x38\x0b\x3e\x0c\x68\x84\x34\x02\x8d\x90\x46\xa0"
+                    "\x11\xd2\x08\x34\x42\x1a\x81\x46\x48\x23\xd0\x08\x69\x04\x1a\x21\x8d\x40\xa3\x4b\xa3\xa3\xd1\xa5"
+                    "\xd1\xd1\xe8\xd2\xe8\xc7\xdd\xf0\xe5\x40\xa3\x4b\xa3\xa3\xd1\xa5\xd1\xd1\xe8\xd2\xe8\x68\x74\x69"
+                    "\x74\x34\xba\x34\x3a\x1a\x5d\x1a\x1d\x8d\x94\x46\xa2\x91\xd2\x48\x34\x52\x1a\x89\x46\x4a\x23\x8f"
+                    "\xb7\xc2\x8f\x05\x1a\x29\x8d\x44\x23\xa5\x91\x68\xa4\x34\x12\x8d\x94\x46\xa2\x91\xd2\x48\x34\x86"
+                    "\x34\x06\x1a\x43\x1a\x03\x8d\x21\x8d\x81\xc6\x90\xc6\x40\x63\x48\x63\x1c\x6f\xa7\x1f\x4f\x34\x86"
+                    "\x34\x06\x1a\x43\x1a\x03\x8d\x21\x8d\x81\xc6\x90\xc6\x40\x63\x4a\x63\xa2\x31\xa5\x31\xd1\x98\xd2"
+                    "\x98\x68\x4c\x69\x4c\x34\xa6\x34\x26\x1a\x53\x1a\xf3\xf8\x4b\xfc\x99\xa0\x31\xa5\x31\xd1\x98\xd2"
+                    "\x98\x68\x4c\x69\x4c\x34\x96\x34\x16\x1a\x4b\x1a\x0b\x8d\x25\x8d\x85\xc6\x92\xc6\x42\x63\x49\x63"
+                    "\xa1\xb1\xa4\xb1\xd0\x58\xd2\x58\xc7\xdf\xea\xcf\x15\x8d\x25\x8d\x85\xc6\x92\xc6\x42\xa3\xa4\x51"
+                    "\x68\x94\x34\x0a\x8d\x92\x46\xa1\x51\xd2\x28\x34\x4a\x1a\x85\x46\x49\xa3\xd0\x28\x69\x14\x1a\x25"
+                    "\x8d\x3a\x76\x0d\x2f\x1b\x68\x94\x34\x0a\x8d\x2d\x8d\x8d\xc6\x96\xc6\x46\x63\x4b\x63\xa3\xb1\xa5"
+                    "\xb1\xd1\xd8\xd2\xd8\x68\x6c\x69\x6c\x34\xb6\x34\x36\x1a\x5b\x1a\x1b\x8d\x2d\x8d\x7d\xec\x5e\x5e"
+                    "\xbe\xfe\x69\xfc\x05\x1f\xd7\x51\x58\x78\x0a\x00\x00";
+            content.assign(gzipped, sizeof(gzipped) - 1);
+            extra = "Content-Encoding: gzip\r\n";
+        }
+        else if (path == "/etag" || path == "/modified") {
+            bool const etag = path == "/etag";
+            std::string_view const validator = etag ? R"("v1")" : "Mon, 12 Oct 2026 10:00:00 GMT";
+            if (header(head, etag ? "if-none-match" : "if-modified-since") == validator) {
+                status = 304;
+                content.clear();
+            }
+            else
+                content = "validated";
+            extra = fmt::format("{}: {}\r\nCache-Control: max-age=0\r\n", etag ? "ETag" : "Last-Modified", validator);
+        }
+        else if (path == "/json")
+            content = R"({"id":7,"name":"book","tags":["a","b"]})";
+        else if (path == "/max-age")
+            extra = fmt::format("Cache-Control: max-age={}\r\n", number(param(target, "s")));
+        else if (method == "POST" || method == "PUT")
+            content = std::string(body);
+        if (method == "HEAD")
+            return fmt::format("HTTP/1.1 {} Status\r\nContent-Length: {}\r\n{}\r\n", status, content.size(), extra);
+        return fmt::format("HTTP/1.1 {} Status\r\nContent-Type: text/plain\r\nContent-Length: {}\r\n{}\r\n{}",
+                           status, content.size(), extra, content);
+    }
+
+    static bool send_all(int const socket, std::string_view data) {
+        while (!data.empty()) {
+            auto const n = send(socket, data.data(), data.size(), MSG_NOSIGNAL);
+            if (n <= 0)
+                return false;
+            data.remove_prefix(static_cast<size_t>(n));
+        }
+        return true;
+    }
+
+    /// Value of the header (case-insensitive name in lower-case).
+    static std::string_view header(std::string_view const head, std::string_view const name) {
+        size_t pos = head.find("\r\n");
+        while (pos != std::string_view::npos && pos + 2 < head.size()) {
+            auto const start = pos + 2;
+            auto const end = head.find("\r\n", start);
+            auto const line = head.substr(start, end - start);
+            auto const colon = line.find(':');
+            if (colon == name.size()) {
+                bool same{true};
+                for (size_t i = 0; i < colon && same; ++i)
+                    same = std::tolower(static_cast<unsigned char>(line[i])) == name[i];
+                if (same) {
+                    auto value = line.substr(colon + 1);
+                    while (!value.empty() && value.front() == ' ')
+                        value.remove_prefix(1);
+                    return value;
+                }
+            }
+            pos = end;
+        }
+        return {};
+    }
+
+    static std::string_view param(std::string_view const target, std::string_view const name) {
+        auto const query = target.find('?');
+        if (query == std::string_view::npos)
+            return {};
+        auto rest = target.substr(query + 1);
+        while (!rest.empty()) {
+            auto const amp = rest.find('&');
+            auto const pair = rest.substr(0, amp);
+            if (pair.starts_with(name) && pair.size() > name.size() && pair[name.size()] == '=')
+                return pair.substr(name.size() + 1);
+            if (amp == std::string_view::npos)
+                break;
+            rest.remove_prefix(amp + 1);
+        }
+        return {};
+    }
+
+    static size_t number(std::string_view const text) {
+        size_t value{};
+        std::from_chars(text.data(), text.data() + text.size(), value);
+        return value;
+    }
+};
@@ -0,0 +1,73 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <algorithm>
+#include "curlex.h"
+#include "check.h"
+#include "server.h"
+
+/// Bodies streamed to a sink arrive whole, in chunks, and aren't buffered
+/// in the response; a sink returning false aborts the transfer.
+int main() {
+    TestServer server;
+    size_t const size = 4 * 1024 * 1024;
+    auto const big = Request().scheme("http").host(server.host()).endpoint("size").add_param("n", static_cast<int64_t>(size)).build();
+
+    for (bool const persistent : {false, true}) {
+        Curlex cx;
+        cx.persistent(persistent);
+        size_t received{}, chunks{};
+        bool all_x{true};
+        auto const response = cx.GET(big, [&](std::span<char const> const chunk) {
+            received += chunk.size();
+            ++chunks;
+            all_x = all_x && std::all_of(chunk.begin(), chunk.end(), [](char c) { return c == 'x'; });
+            return true;
+        });
+        CHECK(response && response->code() == 200);
+        CHECK(response && response->body().empty());
+        CHECK(received == size);
+        CHECK(chunks > 1);
+        CHECK(all_x);
+
+        // The next request without a sink gets its body again.
+        auto const buffered = cx.GET(big);
+        CHECK(buffered && buffered->body().size() == size);
+
+        size_t before_abort{};
+        auto const aborted = cx.GET(big, [&](std::span<char const> const chunk) {
+            before_abort += chunk.size();
+            return false;
+        });
+        CHECK(!aborted && aborted.error().code == CURLE_WRITE_ERROR);
+        CHECK(before_abort < size);
+    }
+    return check::failures;
+}
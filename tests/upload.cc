@@ -0,0 +1,104 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <thread>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include "curlex.h"
+#include "check.h"
+#include "server.h"
+
+/// Streaming uploads (the server echoes the body): regular files read in
+/// chunks and memory mapped, and files without a known size (a FIFO, /proc)
+/// which must be sent chunked instead of as an empty body.
+int main() {
+    TestServer server;
+    Curlex cx;
+    auto const req = Request().scheme("http").host(server.host()).endpoint("echo").build();
+
+    std::string content;
+    for (int i = 0; content.size() < 300'000; ++i)
+        content += fmt::format("line {}\n", i);
+    auto const dir = fmt::format("/tmp/curlex_upload_{}", getpid());
+    ::mkdir(dir.c_str(), 0700);
+    auto const path = dir + "/data";
+    if (auto const file = std::fopen(path.c_str(), "wb")) {
+        std::fwrite(content.data(), 1, content.size(), file);
+        std::fclose(file);
+    }
+
+    for (bool const map : {false, true}) {
+        auto source = Source::file(path, map);
+        CHECK(source && source->size() == content.size());
+        if (source) {
+            auto const response = cx.POST(Request(req).upload(std::move(*source)));
+            CHECK(response && response->body() == content);
+        }
+    }
+
+    // A FIFO reports size 0.
+    auto const fifo = dir + "/fifo";
+    CHECK(::mkfifo(fifo.c_str(), 0600) == 0);
+    std::thread writer([&] {
+        if (auto const file = std::fopen(fifo.c_str(), "wb")) {
+            std::fwrite(content.data(), 1, content.size(), file);
+            std::fclose(file);
+        }
+    });
+    auto source = Source::file(fifo, true);
+    CHECK(source && !source->size());
+    if (source) {
+        auto const response = cx.POST(Request(req).upload(std::move(*source)));
+        CHECK(response && response->body() == content);
+    }
+    writer.join();
+
+    source = Source::file("/proc/self/status");
+    CHECK(source && !source->size());
+    if (source) {
+        auto const response = cx.POST(Request(req).upload(std::move(*source)));
+        CHECK(response && response->body().starts_with("Name:"));
+    }
+
+    // A generator of unknown size.
+    auto const generated = cx.POST(Request(req).upload(Source([&, pos = size_t{}](std::span<char> buffer) mutable {
+        auto const n = std::min(buffer.size(), content.size() - pos);
+        std::memcpy(buffer.data(), content.data() + pos, n);
+        pos += n;
+        return n;
+    })));
+    CHECK(generated && generated->body() == content);
+
+    std::remove(fifo.c_str());
+    std::remove(path.c_str());
+    ::rmdir(dir.c_str());
+    return check::failures;
+}
@@ -0,0 +1,74 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "curlex.h"
+#include "check.h"
+#include "server.h"
+
+/// URLs built in one pass: keys and values of params are percent-encoded
+/// (RFC 3986 unreserved characters stay), and the server receives them so.
+int main() {
+    auto req = Request().scheme("https").host("api.example.com").endpoint("v1/search");
+    CHECK(req.build().url() == "https://api.example.com/v1/search");
+
+    req.add_param("q", "a b&c=d/e?f#g+h%")
+       .add_param("safe", "AZaz09-._~")
+       .add_param("\xc3\xbc" "ber", "\xc3\x9f")
+       .add_param("n", 42)
+       .add_param("neg", -7)
+       .add_param("empty", "");
+    auto const expected = "https://api.example.com/v1/search"
+                          "?q=a%20b%26c%3Dd%2Fe%3Ff%23g%2Bh%25"
+                          "&safe=AZaz09-._~"
+                          "&%C3%BCber=%C3%9F"
+                          "&n=42"
+                          "&neg=-7"
+                          "&empty=";
+    CHECK(req.build().url() == expected);
+    // Building again gives the same URL.
+    CHECK(req.build().url() == expected);
+
+    // Many params (the index of keys is used), in order of adding.
+    Request many;
+    many.scheme("http").host("h").endpoint("");
+    std::string all = "http://h/";
+    for (int i = 0; i < 100; ++i) {
+        many.add_param(fmt::format("k {}", i), fmt::format("v/{}", i));
+        all += fmt::format("{}k%20{}=v%2F{}", i ? '&' : '?', i, i);
+    }
+    CHECK(many.build().url() == all);
+
+    TestServer server;
+    Curlex cx;
+    auto const response = cx.GET(Request().scheme("http").host(server.host()).endpoint("request")
+                                         .add_param("q", "a b&c").add_param("x", "\xc3\x9f").build());
+    CHECK(response && response->body().starts_with("GET /request?q=a%20b%26c&x=%C3%9F HTTP/1.1"));
+    return check::failures;
+}
@@ -0,0 +1,317 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include "transfer.h"
+#include <cstring>
+#include "logger.h"
+#include "version_info.h"
+
+/// Function setting an option of the handle. A failure is stored
+/// in the error and logged with the method's name.
+static auto option_setter(CURL* const handle, Method const method, Error& error) noexcept {
+    return [handle, method, &error](char const* what, CURLoption option, auto value) {
+        if (auto err = curl_easy_setopt(handle, option, value); err) {
+            error.code = err;
+            error.stage = what;
+            logger::print("{}.{}: {}", method_name(method), what, curl_easy_strerror(err));
+            return false;
+        }
+        return true;
+    };
+}
+
+/// Register buffers, callbacks and all options of the request in the handle.
+/// \return true if the handle is ready to be performed.
+bool Transfer::prepare() noexcept {
+    auto const setopt = option_setter(handle_, method_, error_);
+
+    if (!setopt("WRITEFUNCTION", CURLOPT_WRITEFUNCTION, receiver)) return false;
+    if (!setopt("WRITEDATA", CURLOPT_WRITEDATA, this)) return false;
+    if (!setopt("HEADERFUNCTION", CURLOPT_HEADERFUNCTION, collector)) return false;
+    headers_buffer_.reserve(buffers::HEADERS_RESERVE);
+    if (!setopt("HEADERDATA", CURLOPT_HEADERDATA, &headers_buffer_)) return false;
+    // The engine finds the transfer by its handle.
+    if (!setopt("PRIVATE", CURLOPT_PRIVATE, this)) return false;
+
+    if (!set_method(handle_, method_, request_, data_, error_)) return false;
+    if (!set_timeouts(handle_, method_, request_, error_)) return false;
+    if (!set_encoding(handle_, method_, request_, error_)) return false;
+    if (!set_http_version(handle_, method_, request_.http_version().value_or(HttpVersion::Default), error_)) return false;
+    if (cancel_) {
+        if (!setopt("XFERINFOFUNCTION", CURLOPT_XFERINFOFUNCTION, progress)) return false;
+        if (!setopt("XFERINFODATA", CURLOPT_XFERINFODATA, this)) return false;
+        if (!setopt("NOPROGRESS", CURLOPT_NOPROGRESS, 0L)) return false;
+    }
+    if (!setopt("URL", CURLOPT_URL, request_.url().c_str())) return false;
+
+    if ((headers_ = headers_list(request_.headers())))
+        if (!setopt("HTTPHEADER", CURLOPT_HTTPHEADER, headers_)) return false;
+    // Set the verbose option if the request says so
+    if (request_.is_verbose())
+        if (!setopt("VERBOSE", CURLOPT_VERBOSE, 1L)) return false;
+    return true;
+}
+
+/// Collect the result of the performed transfer.
+/// \param result - code returned by curl for the transfer,
+/// \return response with data received from the server or the error.
+Result<Response> Transfer::finish(CURLcode const result) noexcept {
+    if (result) {
+        if (cancel_ && cancel_->load())
+            return Error{result, "CANCELLED"};
+        logger::print("{}.PERFORM: {}", method_name(method_), curl_easy_strerror(result));
+        return Error{result, "PERFORM"};
+    }
+    // Getting the response code sent by the server.
+    long code{};
+    if (auto err = curl_easy_getinfo(handle_, CURLINFO_RESPONSE_CODE, &code); err) {
+        logger::print("{}.RESPONSE_CODE: {}", method_name(method_), curl_easy_strerror(err));
+        return Error{err, "RESPONSE_CODE"};
+    }
+    auto st = stats(handle_);
+    st.decoded = static_cast<int64_t>(body_.size());
+    // Named, so it's moved (not copied) into the result.
+    Response response(code);
+    response.body(std::move(body_))
+            .headers(std::move(headers_buffer_))
+            .stats(st);
+    return response;
+}
+
+//-------------------------------------------------------------------
+/// Set options specific to the method. The handle may keep options
+/// of a previous request, everything the method depends on is set.
+/// \param handle - CURL handle to configure,
+/// \param method - HTTP method,
+/// \param req - the request, its body must live until the transfer ends (curl doesn't copy it),
+/// \param data - state of the reader of 'req.data()',
+/// \param error - set if an option was not accepted,
+/// \return true if all options were accepted.
+//-------------------------------------------------------------------
+bool Transfer::set_method(CURL* const handle, Method const method, Request const& req, Data& data, Error& error) noexcept {
+    auto const setopt = option_setter(handle, method, error);
+    auto const no_string = static_cast<char const*>(nullptr);
+
+    // HTTPGET clears POST, UPLOAD and NOBODY left by a previous request.
+    if (!setopt("HTTPGET", CURLOPT_HTTPGET, 1L)) return false;
+    switch (method) {
+        case Method::GET:
+        case Method::POST:
+            return setopt("CUSTOMREQUEST", CURLOPT_CUSTOMREQUEST, no_string)
+                   && (method == Method::GET || set_body(handle, method, req, data, error));
+        case Method::HEAD:
+            return setopt("CUSTOMREQUEST", CURLOPT_CUSTOMREQUEST, no_string)
+                   && setopt("NOBODY", CURLOPT_NOBODY, 1L);
+        case Method::DELETE:
+        case Method::OPTIONS:
+            return setopt("CUSTOMREQUEST", CURLOPT_CUSTOMREQUEST, method_name(method));
+        case Method::PUT:
+        case Method::PATCH:
+            return setopt("CUSTOMREQUEST", CURLOPT_CUSTOMREQUEST, method_name(method))
+                   && set_body(handle, method, req, data, error);
+    }
+    return false;
+}
+
+/// Set the connect and total timeouts of the request (0 - curl's default).
+/// \return true if all options were accepted.
+bool Transfer::set_timeouts(CURL* const handle, Method const method, Request const& req, Error& error) noexcept {
+    auto const setopt = option_setter(handle, method, error);
+    return setopt("CONNECTTIMEOUT", CURLOPT_CONNECTTIMEOUT_MS, long(req.connect_timeout().count()))
+           && setopt("TIMEOUT", CURLOPT_TIMEOUT_MS, long(req.timeout().count()));
+}
+
+/// Negotiate compression of the response: offer the encodings libcurl
+/// was built with, the body is decoded while it's received.
+/// \return true if the option was accepted.
+bool Transfer::set_encoding(CURL* const handle, Method const method, Request const& req, Error& error) noexcept {
+    static std::string const encodings = VersionInfo::instance().encodings();
+    auto const setopt = option_setter(handle, method, error);
+    bool const on = req.compression() && !encodings.empty();
+    return setopt("ACCEPT_ENCODING", CURLOPT_ACCEPT_ENCODING, on ? encodings.c_str() : nullptr);
+}
+
+/// Select the HTTP version. With HTTP/2 (and HTTP/3) the transfer waits for
+/// a connection it can multiplex on, rather than opening a new one. With prior
+/// knowledge only since libcurl 8.1: older versions (their HTTP/2 code before
+/// the rewrite) break streams started that way.
+/// \return true if all options were accepted.
+bool Transfer::set_http_version(CURL* const handle, Method const method, HttpVersion const version, Error& error) noexcept {
+    constexpr int PRIOR_KNOWLEDGE_PIPEWAIT = 0x080100;
+    auto const& info = VersionInfo::instance();
+    bool const http3 = info.supports(Feature::HTTP3);
+    auto const setopt = option_setter(handle, method, error);
+
+    long value{CURL_HTTP_VERSION_NONE};
+    switch (version) {
+        case HttpVersion::Default:
+            break;
+        case HttpVersion::Http1_1:
+            value = CURL_HTTP_VERSION_1_1;
+            break;
+        case HttpVersion::Http2PriorKnowledge:
+            value = CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE;
+            break;
+        case HttpVersion::Http2Tls:
+            value = CURL_HTTP_VERSION_2TLS;
+            break;
+        case HttpVersion::Http3:
+            value = http3 ? CURL_HTTP_VERSION_3 : CURL_HTTP_VERSION_2TLS;
+            break;
+    }
+    bool const wait = value == CURL_HTTP_VERSION_2TLS || value == CURL_HTTP_VERSION_3
+                      || (value == CURL_HTTP_VERSION_2_PRIOR_KNOWLEDGE && info.version_number >= PRIOR_KNOWLEDGE_PIPEWAIT);
+    return setopt("HTTP_VERSION", CURLOPT_HTTP_VERSION, value)
+           && setopt("PIPEWAIT", CURLOPT_PIPEWAIT, wait ? 1L : 0L);
+}
+
+/// Collect statistics of the finished transfer.
+/// Values which curl can't report stay zero.
+Stats Transfer::stats(CURL* const handle) noexcept {
+    Stats stats{};
+    auto get = [handle](CURLINFO info, auto& value) {
+        curl_off_t v{};
+        if (curl_easy_getinfo(handle, info, &v) == CURLE_OK)
+            value = v;
+    };
+    get(CURLINFO_NAMELOOKUP_TIME_T, stats.name_lookup_us);
+    get(CURLINFO_CONNECT_TIME_T, stats.connect_us);
+    get(CURLINFO_APPCONNECT_TIME_T, stats.tls_us);
+    get(CURLINFO_PRETRANSFER_TIME_T, stats.pretransfer_us);
+    get(CURLINFO_STARTTRANSFER_TIME_T, stats.first_byte_us);
+    get(CURLINFO_TOTAL_TIME_T, stats.total_us);
+    get(CURLINFO_REDIRECT_TIME_T, stats.redirect_us);
+    get(CURLINFO_SIZE_UPLOAD_T, stats.uploaded);
+    get(CURLINFO_SIZE_DOWNLOAD_T, stats.downloaded);
+
+    curl_easy_getinfo(handle, CURLINFO_REDIRECT_COUNT, &stats.redirects);
+    long version{};
+    if (curl_easy_getinfo(handle, CURLINFO_HTTP_VERSION, &version) == CURLE_OK)
+        switch (version) {
+            case CURL_HTTP_VERSION_1_0: stats.http_version = 10; break;
+            case CURL_HTTP_VERSION_1_1: stats.http_version = 11; break;
+            case CURL_HTTP_VERSION_2_0: stats.http_version = 20; break;
+            case CURL_HTTP_VERSION_3: stats.http_version = 30; break;
+            default: break;
+        }
+    long connects{};
+    if (curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &connects) == CURLE_OK)
+        stats.reused = connects == 0;
+    return stats;
+}
+
+/// Create curl's list with headers,
+/// \param headers - user defined vector of pairs key-value.
+/// \return pointer to internally allocated curl's list (nullptr if no headers).
+/// \remark the memory of the list must be manually released.
+struct curl_slist* Transfer::headers_list(std::vector<std::pair<std::string, std::string>> const& headers) noexcept {
+    struct curl_slist* list = nullptr;
+    for (auto const& [k, v] : headers) {
+        auto const text = fmt::format("{}:{}", k, v);
+        list = curl_slist_append(list, text.c_str());
+    }
+    return list;
+}
+
+/// A static function that adds the specified data to a buffer that is a string.
+/// \return number of copied bytes.
+size_t Transfer::collector(char const* const src, size_t const one_item_size, size_t const items_count, void* const dst) noexcept {
+    auto const string = reinterpret_cast<std::string*>(dst);
+    auto const n = one_item_size * items_count;
+    string->append(src, n);
+    return n;
+}
+
+/// Copy data of the request to the curl's upload buffer.
+/// \return number of copied bytes.
+size_t Transfer::data_reader(char* const dst, size_t const one_item_size, size_t const items_count, void* const src) noexcept {
+    auto data = reinterpret_cast<Data*>(src);
+    size_t const max_bytes_to_copy = one_item_size * items_count;
+
+    if (data->left) {
+        auto const n = (data->left > max_bytes_to_copy) ? max_bytes_to_copy : data->left;
+        memcpy(dst, data->ptr, n);
+
+        data->ptr += n;
+        data->left -= n;
+        return n;
+    }
+    return 0;
+}
+
+/********************************************************************
+*                                                                   *
+*                         P R I V A T E                             *
+*                                                                   *
+********************************************************************/
+
+/// Set the body of the request (POST, PUT, PATCH). The first of:
+/// 'body()', 'upload()' (streamed), 'data()' (streamed) is sent.
+bool Transfer::set_body(CURL* const handle, Method const method, Request const& req, Data& data, Error& error) noexcept {
+    auto const setopt = option_setter(handle, method, error);
+
+    if (!setopt("POST", CURLOPT_POST, 1L)) return false;
+    if (!req.body().empty() || (!req.upload() && req.data().empty())) {
+        return setopt("POSTFIELDS", CURLOPT_POSTFIELDS, req.body().c_str())
+               && setopt("POSTFIELDSIZE", CURLOPT_POSTFIELDSIZE_LARGE, curl_off_t(req.body().size()));
+    }
+    if (!setopt("POSTFIELDS", CURLOPT_POSTFIELDS, static_cast<char const*>(nullptr))) return false;
+    if (auto const source = req.upload()) {
+        auto const size = source->size();
+        // Unknown size (-1) means chunked transfer.
+        return setopt("READFUNCTION", CURLOPT_READFUNCTION, Source::reader)
+               && setopt("READDATA", CURLOPT_READDATA, const_cast<Source*>(source))
+               && setopt("POSTFIELDSIZE", CURLOPT_POSTFIELDSIZE_LARGE, size ? curl_off_t(*size) : curl_off_t(-1));
+    }
+    data.ptr = req.data().c_str();
+    data.left = req.data().size();
+    return setopt("READFUNCTION", CURLOPT_READFUNCTION, data_reader)
+           && setopt("READDATA", CURLOPT_READDATA, &data)
+           && setopt("POSTFIELDSIZE", CURLOPT_POSTFIELDSIZE_LARGE, curl_off_t(data.left));
+}
+
+/// A static function that adds the received body data to the body buffer.
+/// The buffer is reserved for the expected size of the body with the first chunk.
+/// \return number of copied bytes.
+size_t Transfer::receiver(char const* const src, size_t const one_item_size, size_t const items_count, void* const self) noexcept {
+    auto const transfer = reinterpret_cast<Transfer*>(self);
+    auto const n = one_item_size * items_count;
+    if (transfer->body_.empty())
+        buffers::reserve_expected(transfer->handle_, transfer->headers_buffer_, transfer->body_);
+    transfer->body_.append(src, n);
+    return n;
+}
+
+/// Progress callback, aborts the transfer when it's cancelled.
+/// \return non-zero to abort the transfer.
+int Transfer::progress(void* const self, curl_off_t, curl_off_t, curl_off_t, curl_off_t) noexcept {
+    auto const transfer = reinterpret_cast<Transfer*>(self);
+    return transfer->cancel_->load(std::memory_order_relaxed) ? 1 : 0;
+}
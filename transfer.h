@@ -0,0 +1,105 @@
+/*
+ *  MIT License
+ *
+ *  Copyright (c) 2024 Piotr Pszczółkowski
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in all
+ *  copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ *  SOFTWARE.
+ *
+ *  Project: curlex
+ *  Author: Piotr Pszczółkowski (piotr@beesoft.pl)
+ *  Created: 2026/10/17
+ */
+#pragma once
+
+/*------- include files:
+-------------------------------------------------------------------*/
+#include <curl/curl.h>
+#include <string>
+#include <atomic>
+#include <memory>
+#include "request.h"
+#include "response.h"
+#include "buffers.h"
+#include "result.h"
+#include "method.h"
+
+/// The state of one transfer: a copy of the request, buffers
+/// for the received data and everything curl keeps pointers to
+/// while the transfer is running. The CURL handle is borrowed.
+class Transfer {
+public:
+    // State of the reader of 'Request::data()'.
+    struct Data { char const* ptr; size_t left; };
+    // Set to true to abort the transfer (or to drop it before the start).
+    using Cancel = std::shared_ptr<std::atomic<bool>>;
+private:
+    CURL* handle_;
+    Method method_;
+    Request request_;
+    std::string body_{};
+    std::string headers_buffer_{};
+    struct curl_slist* headers_{};
+    Data data_{};
+    Error error_{};
+    Cancel cancel_{};
+public:
+    Transfer(CURL* handle, Method method, Request request, Cancel cancel = {}) noexcept
+            : handle_{handle}, method_{method}, request_{std::move(request)}, cancel_{std::move(cancel)} {}
+    ~Transfer() {
+        if (headers_)
+            curl_slist_free_all(headers_);
+    }
+    Transfer(Transfer const&) = delete;
+    Transfer& operator=(Transfer const&) = delete;
+
+    [[nodiscard]] CURL* handle() const noexcept {
+        return handle_;
+    }
+    [[nodiscard]] Method method() const noexcept {
+        return method_;
+    }
+    [[nodiscard]] Request const& request() const noexcept {
+        return request_;
+    }
+    /// Take the request back (e.g. to repeat it).
+    [[nodiscard]] Request release() noexcept {
+        return std::move(request_);
+    }
+    [[nodiscard]] bool prepare() noexcept;
+    [[nodiscard]] Result<Response> finish(CURLcode result) noexcept;
+    /// Why 'prepare()' failed.
+    [[nodiscard]] Error const& error() const noexcept {
+        return error_;
+    }
+
+    // Building blocks shared by all transfer paths (Curlex, Engine).
+    [[nodiscard]] static bool set_method(CURL* handle, Method method, Request const& req, Data& data, Error& error) noexcept;
+    [[nodiscard]] static bool set_timeouts(CURL* handle, Method method, Request const& req, Error& error) noexcept;
+    [[nodiscard]] static bool set_encoding(CURL* handle, Method method, Request const& req, Error& error) noexcept;
+    [[nodiscard]] static bool set_http_version(CURL* handle, Method method, HttpVersion version, Error& error) noexcept;
+    [[nodiscard]] static Stats stats(CURL* handle) noexcept;
+    [[nodiscard]] static struct curl_slist* headers_list(std::vector<std::pair<std::string, std::string>> const& headers) noexcept;
+    static size_t collector(char const* src, size_t one_item_size, size_t items_count, void* dst) noexcept;
+    static size_t data_reader(char* dst, size_t one_item_size, size_t items_count, void* src) noexcept;
+
+private:
+    [[nodiscard]] static bool set_body(CURL* handle, Method method, Request const& req, Data& data, Error& error) noexcept;
+    static size_t receiver(char const* src, size_t one_item_size, size_t items_count, void* self) noexcept;
+    static int progress(void* self, curl_off_t, curl_off_t, curl_off_t, curl_off_t) noexcept;
+};
@@ -31,6 +31,7 @@
 #include "version_info.h"
 #include "shared.h"
 #include <curl/curl.h>
+#include <fmt/core.h>
 #include <string_view>
 #include <algorithm>
 
@@ -41,6 +42,7 @@ VersionInfo::VersionInfo() {
     curl_version = info->version;
     version_number = info->version_num;
     host = info->host;
+    features = info->features;
 
     if (info->ssl_version)
         ssl_version = info->ssl_version;
@@ -50,19 +52,13 @@ VersionInfo::VersionInfo() {
     if (info->protocols) {
         for (auto it = info->protocols; *it != nullptr; it++)
             protocols.emplace_back(*it);
-        std::sort(protocols.begin(), protocols.end(),
-                  [] (std::string_view s0, std::string_view s1)  {
-                      return shared::to_lower(s0) < shared::to_lower(s1);
-                  });
+        std::sort(protocols.begin(), protocols.end(), shared::iless);
     }
 
     if (info->feature_names) {
         for (auto it = info->feature_names; *it; ++it)
             feature_names.emplace_back(*it);
-        std::sort(feature_names.begin(), feature_names.end(),
-                  [] (std::string_view s0, std::string_view s1)  {
-                      return shared::to_lower(s0) < shared::to_lower(s1);
-                  });
+        std::sort(feature_names.begin(), feature_names.end(), shared::iless);
     }
 
     if (info->ares) {
@@ -103,6 +99,19 @@ std::string VersionInfo::as_json() const {
     return glz::prettify_json(json);
 }
 
+std::string VersionInfo::encodings() const {
+    std::vector<std::string> names;
+    if (!zstd_version.empty())
+        names.emplace_back("zstd");
+    if (!brotli_version.empty())
+        names.emplace_back("br");
+    if (!libz_version.empty()) {
+        names.emplace_back("gzip");
+        names.emplace_back("deflate");
+    }
+    return shared::join(names);
+}
+
 void VersionInfo::print() const noexcept {
     fmt::print("curl info {{\n");
     fmt::print("\t           edition: {}\n", edition);
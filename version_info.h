@@ -29,10 +29,38 @@
 
 /*------- include files:
 -------------------------------------------------------------------*/
+#include <curl/curl.h>
 #include <string>
 #include <vector>
 #include <glaze/glaze.hpp>
 
+/// Features of libcurl (bits of 'curl_version_info_data::features').
+enum class Feature : int {
+    IPV6 = CURL_VERSION_IPV6,
+    SSL = CURL_VERSION_SSL,
+    LIBZ = CURL_VERSION_LIBZ,
+    NTLM = CURL_VERSION_NTLM,
+    ASYNCHDNS = CURL_VERSION_ASYNCHDNS,
+    SPNEGO = CURL_VERSION_SPNEGO,
+    LARGEFILE = CURL_VERSION_LARGEFILE,
+    IDN = CURL_VERSION_IDN,
+    TLSAUTH_SRP = CURL_VERSION_TLSAUTH_SRP,
+    HTTP2 = CURL_VERSION_HTTP2,
+    GSSAPI = CURL_VERSION_GSSAPI,
+    KERBEROS5 = CURL_VERSION_KERBEROS5,
+    UNIX_SOCKETS = CURL_VERSION_UNIX_SOCKETS,
+    PSL = CURL_VERSION_PSL,
+    HTTPS_PROXY = CURL_VERSION_HTTPS_PROXY,
+    MULTI_SSL = CURL_VERSION_MULTI_SSL,
+    BROTLI = CURL_VERSION_BROTLI,
+    ALTSVC = CURL_VERSION_ALTSVC,
+    HTTP3 = CURL_VERSION_HTTP3,
+    ZSTD = CURL_VERSION_ZSTD,
+    HSTS = CURL_VERSION_HSTS,
+    GSASL = CURL_VERSION_GSASL,
+    THREADSAFE = CURL_VERSION_THREADSAFE
+};
+
 struct VersionInfo {
 public:
     int edition{};
@@ -59,6 +87,7 @@ public:
     std::string hyper_version{};
     std::string gsasl_version{};
     std::vector<std::string> feature_names;
+    int features{};
 
     struct glaze {
         using T = VersionInfo;
@@ -86,12 +115,24 @@ public:
                 &T::zstd_ver_number,
                 &T::hyper_version,
                 &T::gsasl_version,
-                &T::feature_names
+                &T::feature_names,
+                &T::features
         );
     };
 
     VersionInfo();
+    /// Snapshot of the capabilities, built once (on the first use) and never changed.
+    [[nodiscard]] static VersionInfo const& instance() noexcept {
+        static VersionInfo const info{};
+        return info;
+    }
+    /// Constant-time check of the feature, e.g. supports(Feature::HTTP2).
+    [[nodiscard]] bool supports(Feature const feature) const noexcept {
+        return features & static_cast<int>(feature);
+    }
     [[nodiscard]] std::string as_json() const;
+    /// Content encodings libcurl can decode, preferred first (e.g. "zstd,br,gzip,deflate").
+    [[nodiscard]] std::string encodings() const;
     void print() const noexcept;
 
     std::string version() && {